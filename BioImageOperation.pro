@@ -38,6 +38,18 @@ unix {
     QMAKE_CXXFLAGS_WARN_ON = -Wno-unused-variable -Wno-reorder
 }
 
+unix:!macx {
+    LIBS += -lrt
+}
+
+unix {
+    # output compression (.gz / .zst)
+    DEFINES += HAVE_ZLIB
+    LIBS += -lz
+    #DEFINES += HAVE_ZSTD	# if libzstd-dev installed
+    #LIBS += -lzstd
+}
+
 win32 {
     INCLUDEPATH += C:/opencv/build/include
 
@@ -153,6 +153,14 @@ bool Argument::parseType(ArgumentType argumentType) {
 	case ArgumentType::Position:
 		valueEnum = Util::getListIndex(DrawPositions, value);
 		break;
+
+	case ArgumentType::DropMode:
+		valueEnum = Util::getListIndex(DropModes, value);
+		break;
+
+	case ArgumentType::ContourFormat:
+		valueEnum = Util::getListIndex(ContourFormats, value);
+		break;
 	}
 	if (valueEnum >= 0) {
 		ok = true;
@@ -160,6 +168,17 @@ bool Argument::parseType(ArgumentType argumentType) {
 	return ok;
 }
 
+void Argument::compile() {
+	isNumeric = Util::isNumeric(value);
+	if (isNumeric) {
+		valueNumeric = Util::toDouble(value);
+	}
+	isBoolean = Util::isBoolean(value);
+	if (isBoolean) {
+		valueBoolean = Util::toBoolean(value);
+	}
+}
+
 int Argument::parseClusterDrawMode(string value) {
 	int clusterDrawMode = 0;
 	int clusterDrawMode0;
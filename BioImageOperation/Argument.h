@@ -39,6 +39,8 @@ enum class ArgumentType
 	Format,
 	MedianMode,
 	Position,
+	DropMode,
+	ContourFormat,
 };
 
 enum class ArgumentLabel
@@ -70,6 +72,14 @@ enum class ArgumentLabel
 	Length,
 	Interval,
 	Total,
+	Prefetch,
+	Workers,
+	Stages,
+	Branches,
+	DropMode,
+	Cache,
+	Timeout,
+	Queue,
 	Maximum,
 	Hmin,
 	Hmax,
@@ -96,6 +106,7 @@ enum class ArgumentLabel
 	Format,
 	MedianMode,
 	Contour,
+	ContourFormat,
 	Debug
 };
 
@@ -128,6 +139,14 @@ const vector<string> ArgumentLabels =
 	"Length",
 	"Interval",
 	"Total",
+	"Prefetch",
+	"Workers",
+	"Stages",
+	"Branches",
+	"DropMode",
+	"Cache",
+	"Timeout",
+	"Queue",
 	"Maximum",
 	"Hmin",
 	"Hmax",
@@ -154,6 +173,7 @@ const vector<string> ArgumentLabels =
 	"Format",
 	"MedianMode",
 	"Contour",
+	"ContourFormat",
 	"Debug"
 };
 
@@ -165,10 +185,19 @@ public:
 	ArgumentLabel argumentLabel = ArgumentLabel::None;
 	string value = "";
 	int valueEnum = -1;
+	double valueNumeric = 0;
+	bool isNumeric = false;
+	bool isBoolean = false;
+	bool valueBoolean = false;
 	bool used = false;
 
 	Argument(string arg);
 	ArgumentLabel getArgumentLabel(string arg);
 	bool parseType(ArgumentType argumentType);
+
+	/*
+	 * Pre-parse value once, so value queries need no string conversion
+	 */
+	void compile();
 	int parseClusterDrawMode(string value);
 };
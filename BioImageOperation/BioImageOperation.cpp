@@ -18,6 +18,7 @@
 #endif
 #include "config.h"
 #include "ScriptProcessing.h"
+#include "ColumnStream.h"
 #include "Util.h"
 
 
@@ -29,7 +30,7 @@ Q_DECLARE_METATYPE(string)
 int main(int argc, char *argv[]) {
 	bool hasArguments = (argc > 1);
 	bool showUsage = false;
-	string arg, arg2, min_arg;
+	string arg, arg2, arg3, min_arg;
 
 	try {
 #ifndef _CONSOLE
@@ -66,6 +67,15 @@ int main(int argc, char *argv[]) {
 						} else {
 							showUsage = true;
 						}
+					} else if (min_arg == "convert" && argc > 2) {
+						arg2 = argv[2];
+						if (argc > 3) {
+							arg3 = argv[3];
+						} else {
+							arg3 = Util::combinePath(Util::extractFilePath(arg2), Util::extractFileTitle(arg2) + "." + Constants::defaultDataExtension);
+						}
+						ColumnStream::convertToCsv(arg2, arg3);
+						cout << "Converted to " << arg3 << endl;
 					} else if (min_arg != "version") {
 						cout << "Invalid switch: " << arg << endl;
 						showUsage = true;
@@ -78,7 +88,8 @@ int main(int argc, char *argv[]) {
 				showUsage = true;
 			}
 			if (showUsage) {
-				cout << "Usage: " << PROJECT_NAME << " /path/to/script.bioscript\nScript help usage: -help list / -help [operation] / -help all" << endl;
+				cout << "Usage: " << PROJECT_NAME << " /path/to/script.bioscript\nScript help usage: -help list / -help [operation] / -help all"
+					"\nBinary data to CSV: -convert /path/to/data [/path/to/data.csv]" << endl;
 			}
 #ifndef _CONSOLE
 		}
@@ -26,10 +26,17 @@ void CaptureSource::reset() {
 	height = 0;
 	interval = 1;
 	close();
+	frameTime = -1;
+	prefetch = 0;
+	dropMode = DropMode::DropOldest;
+	droppedFrames = 0;
+	outputFramei = 0;
+	outputFrameTime = -1;
 }
 
 bool CaptureSource::init(string basepath, string filepath, int apiCode, string codecs, string start, string length,
-						 double fps, int interval, int total, int width, int height) {
+						 double fps, int interval, int total, int width, int height, int prefetch, int dropMode,
+						 bool cache, int colorMode, double timeout) {
 	int codec;
 	int width0, height0;
 	double fps0;
@@ -74,6 +81,11 @@ bool CaptureSource::init(string basepath, string filepath, int apiCode, string c
 			fps = fps0;
 		}
 		calcFrameParams(start, length, fps, interval, total, 0);
+		this->prefetch = prefetch;
+		this->dropMode = (DropMode)dropMode;
+		if (prefetch > 0) {
+			startGrabThread();
+		}
 		return true;
 	}
 	return false;
@@ -112,38 +124,102 @@ bool CaptureSource::open() {
 			width = (int)videoCapture.get(VideoCaptureProperties::CAP_PROP_FRAME_WIDTH);
 			height = (int)videoCapture.get(VideoCaptureProperties::CAP_PROP_FRAME_HEIGHT);
 			fps = videoCapture.get(VideoCaptureProperties::CAP_PROP_FPS);
+			openTime = chrono::steady_clock::now();
 		}
 	}
 	return videoIsOpen;
 }
 
 bool CaptureSource::getNextImage(Mat* image) {
+	FrameItem item;
+	bool frameOk = false;
+
+	if (grabThread) {
+		frameOk = frameQueue.pop(item);
+		if (frameOk) {
+			*image = item.image;
+			outputFramei = item.framei;
+			outputFrameTime = item.time;
+		} else {
+			// pass on any error from grab thread
+			frameQueue.checkError();
+		}
+	} else {
+		frameOk = readNextImage(image);
+		outputFramei = framei;
+		outputFrameTime = frameTime;
+	}
+
+	if (!frameOk) {
+		close();
+	} else if (end > 0 && outputFramei >= end) {
+		// reached desired length
+		videoIsOpen = false;
+	}
+
+	return (frameOk && videoIsOpen);
+}
+
+bool CaptureSource::readNextImage(Mat* image) {
 	bool frameOk = false;
 
 	do {
 		frameOk = videoCapture.read(*image);	// need blocking call to respect interval
 		if (!frameOk) {
-			close();
 			break;
 		}
+		frameTime = chrono::duration<double>(chrono::steady_clock::now() - openTime).count();
 		framei++;
 	} while ((framei % interval) != 0);
 
-	if (frameOk) {
-		if (end > 0 && framei >= end) {
-			// reached desired length
-			videoIsOpen = false;
-		}
-	}
-
-	return (frameOk && videoIsOpen);
+	return frameOk;
 }
 
 void CaptureSource::close() {
+	stopGrabThread();
 	videoCapture.release();
 	videoIsOpen = false;
 }
 
+void CaptureSource::startGrabThread() {
+	frameQueue.reset(prefetch);
+	grabStop = false;
+	grabThread = new std::thread(&CaptureSource::grabThreadMethod, this);
+}
+
+void CaptureSource::stopGrabThread() {
+	if (grabThread) {
+		grabStop = true;
+		frameQueue.abort();
+		grabThread->join();
+		delete grabThread;
+		grabThread = nullptr;
+	}
+}
+
+void CaptureSource::grabThreadMethod() {
+	FrameItem item;
+	bool frameOk = true;
+
+	try {
+		while (frameOk && !grabStop) {
+			item.image = Mat();		// new buffer; previous frame owned by queue
+			frameOk = readNextImage(&item.image);
+			if (frameOk) {
+				item.framei = framei;
+				item.time = frameTime;
+				droppedFrames += frameQueue.pushDrop(item, dropMode == DropMode::KeepLatest);
+				if (end > 0 && framei >= end) {
+					break;
+				}
+			}
+		}
+		frameQueue.finish();
+	} catch (...) {
+		frameQueue.finish(current_exception());
+	}
+}
+
 int CaptureSource::getWidth() {
 	return width;
 }
@@ -157,7 +233,7 @@ double CaptureSource::getFps() {
 }
 
 int CaptureSource::getFrameNumber() {
-	return framei;
+	return outputFramei;
 }
 
 string CaptureSource::getLabel() {
@@ -165,9 +241,17 @@ string CaptureSource::getLabel() {
 }
 
 int CaptureSource::getCurrentFrame() {
-	return framei;
+	return outputFramei;
 }
 
 int CaptureSource::getTotalFrames() {
 	return 0;
 }
+
+double CaptureSource::getFrameTime() {
+	return outputFrameTime;
+}
+
+int CaptureSource::getDroppedFrames() {
+	return droppedFrames;
+}
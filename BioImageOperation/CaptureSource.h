@@ -8,7 +8,12 @@
  *****************************************************************************/
 
 #pragma once
+#include <thread>
+#include <atomic>
+#include <chrono>
 #include "FrameSource.h"
+#include "FrameQueue.h"
+#include "Constants.h"
 
 using namespace std;
 using namespace cv;
@@ -29,16 +34,36 @@ public:
 	int framei = 0;
 	int width = 0;
 	int height = 0;
+	chrono::steady_clock::time_point openTime;
+	double frameTime = -1;
+
+	int prefetch = 0;
+	DropMode dropMode = DropMode::DropOldest;
+	std::thread* grabThread = nullptr;
+	atomic<bool> grabStop = false;
+	FrameQueue frameQueue;
+	atomic<int> droppedFrames = 0;
+	int outputFramei = 0;
+	double outputFrameTime = -1;
 
 	CaptureSource();
 	~CaptureSource();
 	void reset();
 	bool init(string basepath, string filepath, int apiCode, string codecs = "", string start = "", string length = "",
-			  double fps = 1, int interval = 1, int total = 0, int width = 0, int height = 0);
+			  double fps = 1, int interval = 1, int total = 0, int width = 0, int height = 0, int prefetch = 0, int dropMode = 0,
+			  bool cache = false, int colorMode = -1, double timeout = 0);
 	bool open();
 	bool getNextImage(Mat* image);
+	bool readNextImage(Mat* image);
 	void close();
 
+	/*
+	 * Prefetch mode: grab frames in separate thread, dropping frames if processing falls behind
+	 */
+	void startGrabThread();
+	void stopGrabThread();
+	void grabThreadMethod();
+
 	int getWidth();
 	int getHeight();
 	double getFps();
@@ -47,4 +72,6 @@ public:
 	string getLabel();
 	int getCurrentFrame();
 	int getTotalFrames();
+	double getFrameTime();
+	int getDroppedFrames();
 };
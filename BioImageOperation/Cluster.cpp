@@ -342,47 +342,95 @@ void Cluster::drawLabel(Mat* image, Scalar color, int drawMode) {
 	}
 }
 
-string Cluster::getCsvHeader(bool outputContour) {
+string Cluster::getCsvHeader(bool outputContour, ContourFormat contourFormat) {
 	string header = "track_label,cluster_label,is_merged"
 		",x,y"
 		",angle"
 		",area,length_major,length_minor,rad";
 	if (outputContour) {
-		header += ",contour";
+		header += (contourFormat == ContourFormat::ChainCode) ? ",contour_chain" : ",contour";
 	}
 	return header;
 }
 
-string Cluster::getCsv(bool outputContour) {
-	string csv;
-	vector<Point> contour;
-    
-	csv = Util::replace(getLabels(), ",", " ") + "," + to_string(clusterLabel);
-	csv += format(",%s", isMerged() ? "true" : "false");
-	csv += format(",%f,%f,%f", x * pixelSize, y * pixelSize, angle);
-	csv += format(",%f,%f,%f,%f", area * pixelSize * pixelSize, lengthMajor * pixelSize, lengthMinor * pixelSize, rad * pixelSize);
+void Cluster::writeCsv(OutputStream* stream, bool outputContour, ContourFormat contourFormat) {
+	double values[nvalues];
+	bool labelStart = true;
+
+	// track labels separated by spaces
+	stream->startValue();
+	for (Track* track : assignedTracks) {
+		if (track->label >= 0) {
+			if (!labelStart) {
+				stream->appendChar(' ');
+			}
+			stream->appendNumber(track->label);
+			labelStart = false;
+		}
+	}
+	stream->addValue(clusterLabel);
+	stream->addValue(isMerged());
+
+	getValues(values);
+	for (double value : values) {
+		stream->addValue(value);
+	}
 
 	if (outputContour) {
-		csv += ",";
-		contour = getContour();
-		for (Point point : contour) {
-			if (pixelSize == 1) {
-				csv += Util::format("%d %d ", point.x, point.y);
-			} else {
-				csv += Util::format("%f %f ", point.x * pixelSize, point.y * pixelSize);
+		writeContour(stream, contourFormat);
+	}
+}
+
+void Cluster::writeContour(OutputStream* stream, ContourFormat contourFormat) {
+	// Freeman chain code by (dy + 1) * 3 + (dx + 1)
+	static const char chainCodes[] = "3214?0567";
+	const vector<Point>& contour = getContour();
+	Point lastPoint;
+
+	stream->startValue();
+	if (contourFormat == ContourFormat::ChainCode) {
+		// start point [pixels], followed by direction code per step
+		if (!contour.empty()) {
+			lastPoint = contour[0];
+			stream->appendNumber(lastPoint.x);
+			stream->appendChar(' ');
+			stream->appendNumber(lastPoint.y);
+			stream->appendChar(' ');
+			for (size_t i = 1; i < contour.size(); i++) {
+				stream->appendChar(chainCodes[(contour[i].y - lastPoint.y + 1) * 3 + (contour[i].x - lastPoint.x + 1)]);
+				lastPoint = contour[i];
 			}
 		}
+		return;
+	}
+	for (const Point& point : contour) {
+		if (pixelSize == 1) {
+			stream->appendNumber(point.x);
+			stream->appendChar(' ');
+			stream->appendNumber(point.y);
+		} else {
+			stream->appendNumber(point.x * pixelSize);
+			stream->appendChar(' ');
+			stream->appendNumber(point.y * pixelSize);
+		}
+		stream->appendChar(' ');
 	}
-	return csv;
 }
 
+void Cluster::getValues(double* values) {
+	double clusterValues[nvalues] = { x * pixelSize, y * pixelSize, angle, area * pixelSize * pixelSize, lengthMajor * pixelSize, lengthMinor * pixelSize, rad * pixelSize };
+	copy(clusterValues, clusterValues + nvalues, values);
+}
 
-vector<Point> Cluster::getContour() {
-	vector<Point> contour;
+const vector<Point>& Cluster::getContour() {
 	vector<vector<Point>> contours;
-	findContours(clusterImage, contours, RetrievalModes::RETR_EXTERNAL, ContourApproximationModes::CHAIN_APPROX_NONE);
-	for (Point point : contours[0]) {
-		contour.push_back(box.tl() + point);
+
+	if (!contourSet) {
+		findContours(clusterImage, contours, RetrievalModes::RETR_EXTERNAL, ContourApproximationModes::CHAIN_APPROX_NONE, box.tl());
+		if (!contours.empty()) {
+			contour = contours[0];
+		}
+		contourSet = true;
 	}
 	return contour;
 }
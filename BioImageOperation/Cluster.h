@@ -11,6 +11,7 @@
 #include <opencv2/opencv.hpp>
 #include "Track.h"
 #include "Constants.h"
+#include "OutputStream.h"
 
 using namespace cv;
 
@@ -25,6 +26,8 @@ class Track;		// forward declaration
 class Cluster
 {
 public:
+	static const int nvalues = 7;
+
 	vector<Track*> assignedTracks;
 
 	int clusterLabel = 0;
@@ -39,6 +42,8 @@ public:
 	Rect box;
 	Moments moments;
 	Mat clusterImage;
+	vector<Point> contour;
+	bool contourSet = false;
 
 	double pixelSize = 1;
 
@@ -75,9 +80,19 @@ public:
 	void drawFill(Mat* image, Scalar color);
 	void drawLabel(Mat* image, Scalar color, int drawMode);
 
-	static string getCsvHeader(bool outputContour = false);
-	string getCsv(bool outputContour = false);
-	vector<Point> getContour();
+	static string getCsvHeader(bool outputContour = false, ContourFormat contourFormat = ContourFormat::Points);
+	void writeCsv(OutputStream* stream, bool outputContour = false, ContourFormat contourFormat = ContourFormat::Points);
+	void writeContour(OutputStream* stream, ContourFormat contourFormat = ContourFormat::Points);
+
+	/*
+	 * Numeric (float) values, in order of header columns from x
+	 */
+	void getValues(double* values);
+
+	/*
+	 * Outer contour, extracted on first use
+	 */
+	const vector<Point>& getContour();
 
 	string toString();
 };
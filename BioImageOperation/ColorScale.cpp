@@ -15,9 +15,15 @@ Vec<uchar, 3> ColorScale::grayTable[scaleLength];
 Vec<uchar, 3> ColorScale::heatTable[scaleLength];
 Vec<uchar, 3> ColorScale::rainbowTable[scaleLength];
 Vec<uchar, 3> ColorScale::labelTable[labelLength];
+once_flag ColorScale::initFlag;
 
 
 void ColorScale::init() {
+	// only once; processing contexts can be created while others are running
+	call_once(initFlag, initTables);
+}
+
+void ColorScale::initTables() {
 	// initialise lookup table
 	double scale;
 	uchar gray;
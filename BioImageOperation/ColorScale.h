@@ -8,8 +8,10 @@
  *****************************************************************************/
 
 #pragma once
+#include <mutex>
 #include <opencv2/opencv.hpp>
 
+using namespace std;
 using namespace cv;
 
 
@@ -19,6 +21,11 @@ using namespace cv;
 
 class ColorScale
 {
+private:
+	static once_flag initFlag;
+
+	static void initTables();
+
 public:
 	static const int colorLevels = 16;											// 256 -> significant memory; anything from 8 actually looks fine
 	static const int scaleLength = colorLevels * colorLevels * colorLevels;
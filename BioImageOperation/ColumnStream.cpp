@@ -0,0 +1,247 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include "ColumnStream.h"
+#include "Util.h"
+
+
+ColumnStream::ColumnStream() {
+}
+
+ColumnStream::~ColumnStream() {
+	try {
+		closeStream();
+	} catch (exception& e) {
+		cerr << e.what() << endl;
+	}
+}
+
+void ColumnStream::reset() {
+	stream.reset();
+	types.clear();
+	columns.clear();
+	listValues.clear();
+	columni = 0;
+	nrows = 0;
+}
+
+void ColumnStream::init(string filename, vector<string> names, vector<ColumnType> types) {
+	string schema;
+	char magic[16] = {};
+	uint32_t schemaLength;
+
+	if (this->types.empty()) {
+		this->types = types;
+		columns.resize(types.size());
+		listValues.resize(types.size());
+		for (size_t i = 0; i < names.size(); i++) {
+			if (i > 0) {
+				schema += ",";
+			}
+			schema += names[i] + ":" + ColumnTypes[(int)types[i]];
+		}
+		strncpy(magic, Constants::columnDataMagic.c_str(), sizeof(magic));
+		schemaLength = (uint32_t)schema.size();
+		stream.init(filename, string(magic, sizeof(magic)) + string((char*)&schemaLength, sizeof(schemaLength)) + schema, true);
+	}
+}
+
+void ColumnStream::add(double value) {
+	int32_t ivalue;
+	uint8_t bvalue;
+
+	switch (types[columni]) {
+	case ColumnType::Int32:
+		ivalue = (int32_t)value;
+		columns[columni].append((char*)&ivalue, sizeof(ivalue));
+		break;
+	case ColumnType::Bool:
+		bvalue = (value != 0);
+		columns[columni].append((char*)&bvalue, sizeof(bvalue));
+		break;
+	case ColumnType::Int32List:
+		addList({ (int)value });
+		return;
+	default:
+		columns[columni].append((char*)&value, sizeof(value));
+		break;
+	}
+	nextColumn();
+}
+
+void ColumnStream::addList(const vector<int>& values) {
+	uint32_t count = (uint32_t)values.size();
+	int32_t ivalue;
+
+	columns[columni].append((char*)&count, sizeof(count));
+	for (int value : values) {
+		ivalue = value;
+		listValues[columni].append((char*)&ivalue, sizeof(ivalue));
+	}
+	nextColumn();
+}
+
+void ColumnStream::nextColumn() {
+	columni++;
+	if (columni >= (int)columns.size()) {
+		columni = 0;
+		nrows++;
+		if (nrows >= Constants::columnChunkRows) {
+			writeChunk();
+		}
+	}
+}
+
+void ColumnStream::writeChunk() {
+	string chunk;
+	uint32_t chunkRows = nrows;
+	uint32_t nvalues;
+
+	if (nrows > 0) {
+		chunk.append((char*)&chunkRows, sizeof(chunkRows));
+		for (size_t i = 0; i < columns.size(); i++) {
+			if (types[i] == ColumnType::Int32List) {
+				nvalues = (uint32_t)(listValues[i].size() / sizeof(int32_t));
+				chunk.append((char*)&nvalues, sizeof(nvalues));
+			}
+			chunk += columns[i];
+			chunk += listValues[i];
+			columns[i].clear();
+			listValues[i].clear();
+		}
+		nrows = 0;
+		stream.write(chunk);
+	}
+}
+
+void ColumnStream::closeStream() {
+	if (!stream.errorMode) {
+		writeChunk();
+	}
+	stream.closeStream();
+}
+
+size_t ColumnStream::getTypeSize(ColumnType type) {
+	switch (type) {
+	case ColumnType::Int32: return sizeof(int32_t);
+	case ColumnType::Bool: return sizeof(uint8_t);
+	case ColumnType::Int32List: return sizeof(uint32_t);
+	default: return sizeof(double);
+	}
+}
+
+void ColumnStream::convertToCsv(string filename, string csvFilename) {
+	ifstream input(filename, ios_base::in | ios_base::binary);
+	OutputStream output;
+	vector<ColumnType> types;
+	vector<string> names;
+	vector<string> columns;
+	vector<string> listValues;
+	vector<size_t> listPositions;
+	string csv;
+	string schema;
+	char magic[16];
+	uint32_t schemaLength;
+	uint32_t chunkRows;
+	uint32_t nvalues;
+	uint32_t count;
+	int typei;
+	int32_t ivalue;
+	double value;
+	const char* data;
+
+	if (!input.is_open()) {
+		throw ios_base::failure("Unable to read file " + filename);
+	}
+	if (filesystem::weakly_canonical(filename) == filesystem::weakly_canonical(csvFilename)) {
+		// output would truncate input
+		throw ios_base::failure("Output file same as input file " + filename);
+	}
+	input.read(magic, sizeof(magic));
+	input.read((char*)&schemaLength, sizeof(schemaLength));
+	if (!input || strncmp(magic, Constants::columnDataMagic.c_str(), sizeof(magic)) != 0) {
+		throw ios_base::failure("Invalid columnar data file " + filename);
+	}
+	schema.resize(schemaLength);
+	input.read(schema.data(), schemaLength);
+
+	for (string column : Util::split(schema, ",")) {
+		vector<string> parts = Util::split(column, ":");
+		typei = (parts.size() == 2) ? Util::getListIndex(ColumnTypes, parts[1]) : -1;
+		if (typei < 0) {
+			throw ios_base::failure("Invalid columnar data file " + filename);
+		}
+		names.push_back(parts[0]);
+		types.push_back((ColumnType)typei);
+	}
+	columns.resize(types.size());
+	listValues.resize(types.size());
+	listPositions.resize(types.size());
+
+	for (size_t i = 0; i < names.size(); i++) {
+		csv += (i > 0 ? "," : "") + names[i];
+	}
+	output.init(csvFilename, csv + "\n");
+
+	while (input.read((char*)&chunkRows, sizeof(chunkRows))) {
+		for (size_t i = 0; i < columns.size(); i++) {
+			nvalues = 0;
+			if (types[i] == ColumnType::Int32List && !input.read((char*)&nvalues, sizeof(nvalues))) {
+				throw ios_base::failure("Incomplete columnar data file " + filename);
+			}
+			columns[i].resize(chunkRows * getTypeSize(types[i]));
+			listValues[i].resize(nvalues * sizeof(int32_t));
+			listPositions[i] = 0;
+			if (!input.read(columns[i].data(), columns[i].size()) || !input.read(listValues[i].data(), listValues[i].size())) {
+				throw ios_base::failure("Incomplete columnar data file " + filename);
+			}
+		}
+		csv = "";
+		for (uint32_t rowi = 0; rowi < chunkRows; rowi++) {
+			for (size_t i = 0; i < columns.size(); i++) {
+				if (i > 0) {
+					csv += ",";
+				}
+				data = columns[i].data() + rowi * getTypeSize(types[i]);
+				switch (types[i]) {
+				case ColumnType::Int32:
+					memcpy(&ivalue, data, sizeof(ivalue));
+					csv += to_string(ivalue);
+					break;
+				case ColumnType::Bool:
+					csv += (*data != 0) ? "true" : "false";
+					break;
+				case ColumnType::Int32List:
+					// values separated by spaces (as CSV output)
+					memcpy(&count, data, sizeof(count));
+					if (listPositions[i] + count * sizeof(int32_t) > listValues[i].size()) {
+						throw ios_base::failure("Invalid columnar data file " + filename);
+					}
+					for (uint32_t valuei = 0; valuei < count; valuei++) {
+						memcpy(&ivalue, listValues[i].data() + listPositions[i], sizeof(ivalue));
+						listPositions[i] += sizeof(ivalue);
+						csv += (valuei > 0 ? " " : "") + to_string(ivalue);
+					}
+					break;
+				default:
+					memcpy(&value, data, sizeof(value));
+					csv += Util::format("%f", value);
+					break;
+				}
+			}
+			csv += "\n";
+		}
+		output.write(csv);
+	}
+	output.closeStream();
+}
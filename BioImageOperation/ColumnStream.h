@@ -0,0 +1,66 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "OutputStream.h"
+#include "Constants.h"
+
+using namespace std;
+
+
+/*
+ * Binary columnar data file (native little-endian):
+ * header (16 character identifier, 32-bit schema length, schema text "name:type,..."),
+ * followed by chunks (32-bit number of rows, followed by all values of each column in turn).
+ * List column in chunk: 32-bit total number of values, 32-bit count of each row, followed by all values
+ */
+
+class ColumnStream
+{
+public:
+	OutputStream stream;
+	vector<ColumnType> types;
+	vector<string> columns;			// column data of current chunk (list column: row counts)
+	vector<string> listValues;		// list column values of current chunk
+	int columni = 0;
+	int nrows = 0;
+
+	ColumnStream();
+	~ColumnStream();
+	void reset();
+	void init(string filename, vector<string> names, vector<ColumnType> types);
+
+	/*
+	 * Add value to next column (converted to column type); row complete after last column
+	 */
+	void add(double value);
+
+	/*
+	 * Add values to next (list) column
+	 */
+	void addList(const vector<int>& values);
+	void nextColumn();
+	void writeChunk();
+
+	/*
+	 * Write remaining rows and close file
+	 */
+	void closeStream();
+
+	static size_t getTypeSize(ColumnType type);
+
+	/*
+	 * Convert binary columnar data file to CSV file
+	 */
+	static void convertToCsv(string filename, string csvFilename);
+};
@@ -13,9 +13,16 @@
 const string Constants::defaultScriptExtension = "bioscript";
 const string Constants::defaultHelpExtension = "md";
 const string Constants::defaultDataExtension = "csv";
+const string Constants::defaultBinaryDataExtension = "bin";
 const string Constants::defaultImageExtension = "png";
 const string Constants::defaultVideoExtension = "mp4";
 const string Constants::defaultVideoCodec = "H264";
+const string Constants::videoIndexExtension = "bioindex";
+const string Constants::videoInfoCacheFilename = "videoinfo." + videoIndexExtension;
+const string Constants::frameCacheExtension = "biocache";
+const string Constants::frameCacheMagic = "BIOFRAMECACHE1";
+const string Constants::frameRingMagic = "BIOFRAMERING1";
+const string Constants::columnDataMagic = "BIOCOLUMNS1";
 const string Constants::scriptFileDialogFilter = "BIO Script files (*." + defaultScriptExtension + ")";
 const string Constants::scriptHelpDialogFilter = "BIO script help (*." + defaultHelpExtension + ")";
 const int Constants::defaultScriptFileDialogFilter = 1;
@@ -28,6 +35,7 @@ const string Constants::trackingScriptTemplate = scriptTemplatePath + "template_
 const string Constants::filenameTemplate = "<filename>";
 
 const int Constants::seekModeInterval = 100;
+const double Constants::segmentOverlapTime = 10;
 const int Constants::minPixels = 2;
 const int Constants::maxMergedBlobs = 5;
 const int Constants::minPathDistance = 2;
@@ -27,8 +27,11 @@ enum class ScriptOperationType
 	Source,
 	CreateImage,
 	OpenImage,
+	OpenStack,
 	OpenVideo,
 	OpenCapture,
+	OpenPipe,
+	OpenSharedMemory,
 	SaveImage,
 	SaveVideo,
 	ShowImage,
@@ -87,6 +90,7 @@ enum class ScriptOperationType
 
 	ShowTrackInfo,
 	SaveTrackInfo,
+	SaveCaptureInfo,
 	DrawLegend,
 
 	Wait,
@@ -103,8 +107,11 @@ const vector<string> ScriptOperationTypes =
 	"Source",
 	"CreateImage",
 	"OpenImage",
+	"OpenStack",
 	"OpenVideo",
 	"OpenCapture",
+	"OpenPipe",
+	"OpenSharedMemory",
 	"SaveImage",
 	"SaveVideo",
 	"ShowImage",
@@ -163,6 +170,7 @@ const vector<string> ScriptOperationTypes =
 
 	"ShowTrackInfo",
 	"SaveTrackInfo",
+	"SaveCaptureInfo",
 	"DrawLegend",
 
 	"Wait",
@@ -196,22 +204,50 @@ const vector<string> MessageLevels =
 enum class FrameType
 {
 	Image,
+	Stack,
 	Video,
-	Capture
+	Capture,
+	Pipe,
+	SharedMemory
 };
 
 enum class SaveFormat
 {
 	ByTime,
 	ByLabel,
-	Split
+	Split,
+	Binary
 };
 
 const vector<string> SaveFormats =
 {
 	"ByTime",
 	"ByLabel",
-	"Split"
+	"Split",
+	"Binary"
+};
+
+enum class ColumnType
+{
+	Int32,
+	Float64,
+	Bool,
+	Int32List
+};
+
+const vector<string> ColumnTypes =
+{
+	"int32",
+	"float64",
+	"bool",
+	"int32list"
+};
+
+enum class CompressionType
+{
+	None,
+	Gzip,
+	Zstd
 };
 
 enum class ImageColorMode
@@ -256,6 +292,30 @@ const vector<string> MedianModes =
 	"Dark"
 };
 
+enum class ContourFormat
+{
+	Points,
+	ChainCode
+};
+
+const vector<string> ContourFormats =
+{
+	"Points",
+	"ChainCode"
+};
+
+enum class DropMode
+{
+	DropOldest,
+	KeepLatest
+};
+
+const vector<string> DropModes =
+{
+	"DropOldest",
+	"KeepLatest"
+};
+
 enum class ClusterDrawMode : int
 {
 	None = 0,
@@ -359,13 +419,25 @@ public:
 	static const int nDisplays = 4;
 	static const int nTextWindows = 4;
 	static const int maxLogBuffer = 1000000;
+	static const int maxOpenStreams = 256;
+	static const size_t maxTotalBuffered = 100000000;
+	static const int maxNumberLength = 320;
+	static const int columnChunkRows = 65536;
+	static const int pipelineQueueSize = 2;
 
 	static const string defaultScriptExtension;
 	static const string defaultHelpExtension;
 	static const string defaultDataExtension;
+	static const string defaultBinaryDataExtension;
 	static const string defaultImageExtension;
 	static const string defaultVideoExtension;
 	static const string defaultVideoCodec;
+	static const string videoIndexExtension;
+	static const string videoInfoCacheFilename;
+	static const string frameCacheExtension;
+	static const string frameCacheMagic;
+	static const string frameRingMagic;
+	static const string columnDataMagic;
 	static const string scriptFileDialogFilter;
 	static const string scriptHelpDialogFilter;
 	static const int defaultScriptFileDialogFilter;
@@ -378,6 +450,7 @@ public:
 	static const string filenameTemplate;
 
 	static const int seekModeInterval;
+	static const double segmentOverlapTime;
 	static const int minPixels;
 	static const int maxMergedBlobs;
 	static const int minPathDistance;
@@ -0,0 +1,125 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#ifdef __linux__
+#include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+#include "DirectoryWatcher.h"
+#include "Util.h"
+
+
+DirectoryWatcher::DirectoryWatcher() {
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+	close();
+}
+
+void DirectoryWatcher::open(string searchpath) {
+	close();
+
+	path = Util::extractFilePath(searchpath);
+	pattern = Util::createFilePatternRegex(Util::extractFileName(searchpath));
+
+#ifdef __linux__
+	watchHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (watchHandle < 0 || inotify_add_watch(watchHandle, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		close();
+		throw ios_base::failure("Unable to watch folder " + path);
+	}
+#endif
+}
+
+void DirectoryWatcher::close() {
+#ifdef __linux__
+	if (watchHandle >= 0) {
+		::close(watchHandle);
+		watchHandle = -1;
+	}
+#else
+	sizes.clear();
+#endif
+	known.clear();
+	pending.clear();
+}
+
+void DirectoryWatcher::addKnown(string filename) {
+	known.insert(filename);
+	pending.erase(filename);
+}
+
+bool DirectoryWatcher::getNextFilename(string* filename, double timeout) {
+	chrono::steady_clock::time_point waitStart = chrono::steady_clock::now();
+
+	while (pending.empty()) {
+		if (chrono::duration<double>(chrono::steady_clock::now() - waitStart).count() >= timeout) {
+			return false;
+		}
+		checkChanges(pollInterval);
+	}
+	*filename = *pending.begin();
+	addKnown(*filename);
+	return true;
+}
+
+void DirectoryWatcher::checkChanges(int waitTime) {
+#ifdef __linux__
+	// inotify: file complete once closed after writing, or moved into folder
+	alignas(inotify_event) char buffer[4096];
+	const inotify_event* event;
+	pollfd pollHandle = { watchHandle, POLLIN, 0 };
+	ssize_t len;
+
+	if (poll(&pollHandle, 1, waitTime) > 0) {
+		while ((len = read(watchHandle, buffer, sizeof(buffer))) > 0) {
+			for (char* ptr = buffer; ptr < buffer + len; ptr += sizeof(inotify_event) + event->len) {
+				event = (const inotify_event*)ptr;
+				if (event->len > 0) {
+					addFile(Util::combinePath(path, event->name));
+				}
+			}
+		}
+	}
+#else
+	// poll: file complete once its size is stable between checks
+	map<string, uintmax_t> newSizes;
+	string filename;
+	uintmax_t size;
+	error_code error;
+
+	this_thread::sleep_for(chrono::milliseconds(waitTime));
+
+	for (const auto& entry : filesystem::directory_iterator(path)) {
+		filename = entry.path().string();
+		if (known.count(filename) == 0 && pending.count(filename) == 0 && regex_match(Util::extractFileName(filename), pattern)) {
+			size = entry.file_size(error);
+			if (error) {
+				continue;
+			}
+			if (size > 0 && sizes.count(filename) > 0 && sizes[filename] == size) {
+				addFile(filename);
+			} else {
+				newSizes[filename] = size;
+			}
+		}
+	}
+	sizes = newSizes;
+#endif
+}
+
+void DirectoryWatcher::addFile(string filename) {
+	if (known.count(filename) == 0 && regex_match(Util::extractFileName(filename), pattern)) {
+		pending.insert(filename);
+	}
+}
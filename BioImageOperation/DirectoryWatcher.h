@@ -0,0 +1,59 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <string>
+#include <set>
+#include <map>
+#include <regex>
+#include <cstdint>
+
+using namespace std;
+
+
+/*
+ * Watches folder for new files matching file name pattern, handed over once completely written.
+ * Uses inotify on Linux, otherwise polls folder for files with stable size
+ */
+
+class DirectoryWatcher
+{
+public:
+	static const int pollInterval = 100;	// [ms]
+
+	string path = "";
+
+	DirectoryWatcher();
+	~DirectoryWatcher();
+	void open(string searchpath);
+	void close();
+
+	/*
+	 * Mark file as already handled (i.e. existing when opened)
+	 */
+	void addKnown(string filename);
+
+	/*
+	 * Wait for next new file (in file name order of files available); returns false if none after timeout [s]
+	 */
+	bool getNextFilename(string* filename, double timeout);
+
+private:
+	regex pattern;
+	set<string> known;
+	set<string> pending;
+#ifdef __linux__
+	int watchHandle = -1;
+#else
+	map<string, uintmax_t> sizes;
+#endif
+
+	void checkChanges(int waitTime);
+	void addFile(string filename);
+};
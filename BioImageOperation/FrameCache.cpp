@@ -0,0 +1,300 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include <filesystem>
+#include <sstream>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include "FrameCache.h"
+#include "Constants.h"
+#include "Util.h"
+
+
+mutex FrameCache::closedMapsMutex;
+vector<pair<uchar*, size_t>> FrameCache::closedMaps;
+
+
+FrameCache::FrameCache() {
+}
+
+FrameCache::~FrameCache() {
+	close();
+}
+
+void FrameCache::reset() {
+	close();
+	filename = "";
+	key = "";
+	width = 0;
+	height = 0;
+	type = 0;
+	nframes = 0;
+	initialFramei = 0;
+	slotSize = 0;
+}
+
+bool FrameCache::openRead(string filename, string key) {
+	ifstream input;
+	string magic, fileKey;
+	char header[headerSize] = {};
+	int complete = 0;
+
+	reset();
+	if (!filesystem::exists(filename)) {
+		return false;
+	}
+
+	input.open(filename, ios_base::binary);
+	if (!input.is_open()) {
+		return false;
+	}
+	input.read(header, headerSize - 1);
+	input.close();
+
+	istringstream headerStream(header);
+	getline(headerStream, magic);
+	getline(headerStream, fileKey);
+	headerStream >> width >> height >> type >> nframes >> initialFramei >> complete;
+	if (magic != Constants::frameCacheMagic || fileKey != key || !complete || width <= 0 || height <= 0) {
+		return false;
+	}
+
+	this->filename = filename;
+	this->key = key;
+	slotSize = frameHeaderSize + ((Mat(1, 1, type).elemSize() * width * height + slotAlignment - 1) / slotAlignment) * slotAlignment;
+	if (!map()) {
+		return false;
+	}
+	if (mapSize < headerSize + slotSize * nframes) {
+		// truncated
+		unmap();
+		return false;
+	}
+	return true;
+}
+
+bool FrameCache::getFrame(int i, Mat* image, int* framei, string* label) {
+	uchar* slot;
+
+	if (!mapData || i < 0 || i >= nframes) {
+		return false;
+	}
+	slot = mapData + headerSize + slotSize * i;
+	memcpy(framei, slot, sizeof(int));
+	*label = string((char*)slot + sizeof(int));
+	// zero-copy: header only; memory is mapped copy on write, so in-place changes don't affect the cache
+	*image = Mat(height, width, type, slot + frameHeaderSize);
+	return true;
+}
+
+bool FrameCache::isReading() {
+	return (mapData != nullptr);
+}
+
+bool FrameCache::openWrite(string filename, string key, int initialFramei) {
+	string header;
+
+	reset();
+	this->filename = filename;
+	this->key = key;
+	this->initialFramei = initialFramei;
+
+	try {
+		output.open(filename + ".tmp", ios_base::binary | ios_base::trunc);
+	} catch (exception&) {
+	}
+	if (!output.is_open()) {
+		// optional cache; ignore if not writable
+		return false;
+	}
+	header = getHeader(false);
+	output.write(header.c_str(), headerSize);
+	chunkn = 0;
+	writing = true;
+	return true;
+}
+
+void FrameCache::writeFrame(const Mat& image, int framei, string label) {
+	uchar* slot;
+	size_t dataSize = image.elemSize() * image.cols * image.rows;
+
+	if (!writing) {
+		return;
+	}
+	if (nframes == 0) {
+		width = image.cols;
+		height = image.rows;
+		type = image.type();
+		slotSize = frameHeaderSize + ((dataSize + slotAlignment - 1) / slotAlignment) * slotAlignment;
+		chunk.resize(slotSize * chunkFrames);
+	} else if (image.cols != width || image.rows != height || image.type() != type) {
+		// frames not uniform; cache not supported
+		discardWrite();
+		return;
+	}
+
+	slot = chunk.data() + slotSize * chunkn;
+	memset(slot, 0, frameHeaderSize);
+	memcpy(slot, &framei, sizeof(int));
+	strncpy((char*)slot + sizeof(int), label.c_str(), frameHeaderSize - sizeof(int) - 1);
+	if (image.isContinuous()) {
+		memcpy(slot + frameHeaderSize, image.data, dataSize);
+	} else {
+		image.copyTo(Mat(height, width, type, slot + frameHeaderSize));
+	}
+	nframes++;
+	chunkn++;
+	if (chunkn >= chunkFrames) {
+		writeChunk();
+	}
+}
+
+void FrameCache::writeChunk() {
+	if (chunkn > 0) {
+		output.write((char*)chunk.data(), slotSize * chunkn);
+		chunkn = 0;
+		if (!output.good()) {
+			discardWrite();
+		}
+	}
+}
+
+void FrameCache::finishWrite() {
+	string header;
+
+	if (!writing) {
+		return;
+	}
+	writeChunk();
+	if (!writing || nframes == 0) {
+		discardWrite();
+		return;
+	}
+	header = getHeader(true);
+	output.seekp(0);
+	output.write(header.c_str(), headerSize);
+	output.close();
+	writing = false;
+	chunk.clear();
+	try {
+		filesystem::rename(filename + ".tmp", filename);
+	} catch (exception&) {
+		filesystem::remove(filename + ".tmp");
+	}
+}
+
+void FrameCache::discardWrite() {
+	if (output.is_open()) {
+		output.close();
+	}
+	if (writing) {
+		try {
+			filesystem::remove(filename + ".tmp");
+		} catch (exception&) {
+		}
+	}
+	writing = false;
+	chunk.clear();
+	chunkn = 0;
+}
+
+bool FrameCache::isWriting() {
+	return writing;
+}
+
+void FrameCache::close() {
+	// incomplete cache is not kept
+	discardWrite();
+	unmap();
+}
+
+string FrameCache::getHeader(bool complete) {
+	string header = Constants::frameCacheMagic + "\n" + key + "\n"
+		+ Util::format("%d %d %d %d %d %d\n", width, height, type, nframes, initialFramei, complete ? 1 : 0);
+	header.resize(headerSize, '\0');
+	return header;
+}
+
+bool FrameCache::map() {
+#ifdef _WIN32
+	LARGE_INTEGER fileSize;
+
+	fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	GetFileSizeEx(fileHandle, &fileSize);
+	mapSize = (size_t)fileSize.QuadPart;
+	mapHandle = CreateFileMappingA(fileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (mapHandle) {
+		mapData = (uchar*)MapViewOfFile(mapHandle, FILE_MAP_COPY, 0, 0, 0);
+	}
+#else
+	fileHandle = ::open(filename.c_str(), O_RDONLY);
+	if (fileHandle < 0) {
+		return false;
+	}
+	mapSize = (size_t)lseek(fileHandle, 0, SEEK_END);
+	void* data = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileHandle, 0);
+	if (data != MAP_FAILED) {
+		mapData = (uchar*)data;
+		madvise(data, mapSize, MADV_SEQUENTIAL);
+	}
+#endif
+	if (!mapData) {
+		unmap();
+		return false;
+	}
+	return true;
+}
+
+void FrameCache::unmap() {
+	if (mapData) {
+		lock_guard<mutex> lock(closedMapsMutex);
+		closedMaps.push_back({ mapData, mapSize });
+	}
+#ifdef _WIN32
+	if (mapHandle) {
+		CloseHandle(mapHandle);
+		mapHandle = NULL;
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (fileHandle >= 0) {
+		::close(fileHandle);
+		fileHandle = -1;
+	}
+#endif
+	mapData = nullptr;
+	mapSize = 0;
+}
+
+void FrameCache::releaseMaps() {
+	lock_guard<mutex> lock(closedMapsMutex);
+	for (auto& closedMap : closedMaps) {
+#ifdef _WIN32
+		UnmapViewOfFile(closedMap.first);
+#else
+		munmap(closedMap.first, closedMap.second);
+#endif
+	}
+	closedMaps.clear();
+}
+
+string FrameCache::getCacheFilename(string filename, string key) {
+	// cache per source settings
+	return filename + Util::format(".%zx.", hash<string>{}(key)) + Constants::frameCacheExtension;
+}
@@ -0,0 +1,96 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <opencv2/opencv.hpp>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace std;
+using namespace cv;
+
+
+/*
+ * Cache of decoded source frames, in file next to the source.
+ * Frames are stored uncompressed in fixed size slots, written in chunks and read through a (copy on write) memory map
+ */
+
+class FrameCache
+{
+public:
+	static const int headerSize = 4096;
+	static const int frameHeaderSize = 64;
+	static const int slotAlignment = 64;
+	static const int chunkFrames = 16;
+
+	string filename = "";
+	string key = "";
+	int width = 0;
+	int height = 0;
+	int type = 0;
+	int nframes = 0;
+	int initialFramei = 0;
+	size_t slotSize = 0;
+
+	FrameCache();
+	~FrameCache();
+	void reset();
+
+	/*
+	 * Open complete cache with matching key for reading
+	 */
+	bool openRead(string filename, string key);
+	bool getFrame(int i, Mat* image, int* framei, string* label);
+	bool isReading();
+
+	/*
+	 * Write cache while decoding; only made available once complete
+	 */
+	bool openWrite(string filename, string key, int initialFramei);
+	void writeFrame(const Mat& image, int framei, string label);
+	void finishWrite();
+	bool isWriting();
+
+	void close();
+
+	static string getCacheFilename(string filename, string key);
+
+	/*
+	 * Unmap closed caches; frames (Mat headers) can be referenced until processing is reset
+	 */
+	static void releaseMaps();
+
+private:
+	static mutex closedMapsMutex;
+	static vector<pair<uchar*, size_t>> closedMaps;
+
+	uchar* mapData = nullptr;
+	size_t mapSize = 0;
+#ifdef _WIN32
+	HANDLE fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE mapHandle = NULL;
+#else
+	int fileHandle = -1;
+#endif
+	ofstream output;
+	vector<uchar> chunk;
+	int chunkn = 0;
+	bool writing = false;
+
+	string getHeader(bool complete);
+	bool map();
+	void unmap();
+	void writeChunk();
+	void discardWrite();
+};
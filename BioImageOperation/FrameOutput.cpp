@@ -8,3 +8,8 @@
  *****************************************************************************/
 
 #include "FrameOutput.h"
+
+
+string FrameOutput::getStatistics() {
+	return "";
+}
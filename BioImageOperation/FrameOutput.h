@@ -22,7 +22,13 @@ class FrameOutput
 {
 public:
 	virtual void reset() = 0;
-	virtual void init(string basepath, string templatePath, string defaultExtension = "", string start = "", string length = "", double fps = 0, string codecs = "") = 0;
+	virtual void init(string basepath, string templatePath, string defaultExtension = "", string start = "", string length = "", double fps = 0, string codecs = "",
+					  int queue = 0) = 0;
 	virtual bool writeImage(Mat* image) = 0;
 	virtual void close() = 0;
+
+	/*
+	 * Background writing statistics, available after close
+	 */
+	virtual string getStatistics();
 };
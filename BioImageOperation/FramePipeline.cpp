@@ -0,0 +1,120 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include "FramePipeline.h"
+
+
+FramePipeline::FramePipeline() {
+}
+
+FramePipeline::~FramePipeline() {
+	abort();
+}
+
+void FramePipeline::start(vector<function<void(FrameItem&)>> stages, int queueSize) {
+	FrameQueue* queue;
+
+	abort();
+	this->stages = stages;
+	error = nullptr;
+
+	for (int stagei = 0; stagei < stages.size(); stagei++) {
+		queue = new FrameQueue();
+		queue->reset(queueSize);
+		queues.push_back(queue);
+	}
+	for (int stagei = 0; stagei < stages.size(); stagei++) {
+		threads.push_back(new std::thread(&FramePipeline::stageThreadMethod, this, stagei));
+	}
+}
+
+void FramePipeline::push(FrameItem& item) {
+	if (queues.empty() || !queues[0]->push(item)) {
+		// aborted by failed stage
+		join();
+	}
+	checkError();
+}
+
+void FramePipeline::finish() {
+	if (!queues.empty()) {
+		queues[0]->finish();
+	}
+	join();
+	checkError();
+}
+
+void FramePipeline::abort() {
+	for (FrameQueue* queue : queues) {
+		queue->abort();
+	}
+	join();
+}
+
+int FramePipeline::getStageCount() {
+	return (int)stages.size();
+}
+
+void FramePipeline::stageThreadMethod(int stagei) {
+	FrameQueue* input = queues[stagei];
+	FrameQueue* output = nullptr;
+	FrameItem item;
+
+	if (stagei + 1 < queues.size()) {
+		output = queues[stagei + 1];
+	}
+
+	try {
+		while (input->pop(item)) {
+			stages[stagei](item);
+			if (output && !output->push(item)) {
+				break;
+			}
+		}
+		if (output) {
+			output->finish();
+		}
+	} catch (...) {
+		{
+			lock_guard<mutex> lock(errorMutex);
+			if (!error) {
+				error = current_exception();
+			}
+		}
+		// stop all stages; frames in flight discarded
+		for (FrameQueue* queue : queues) {
+			queue->abort();
+		}
+	}
+}
+
+void FramePipeline::join() {
+	for (std::thread* thread : threads) {
+		thread->join();
+		delete thread;
+	}
+	threads.clear();
+
+	for (FrameQueue* queue : queues) {
+		delete queue;
+	}
+	queues.clear();
+}
+
+void FramePipeline::checkError() {
+	exception_ptr error0;
+	{
+		lock_guard<mutex> lock(errorMutex);
+		error0 = error;
+		error = nullptr;
+	}
+	if (error0) {
+		rethrow_exception(error0);
+	}
+}
@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <exception>
+#include "FrameQueue.h"
+
+using namespace std;
+
+
+/*
+ * Pipeline of stages, each processing frames in order in its own thread, connected by bounded frame queues
+ */
+
+class FramePipeline
+{
+public:
+	FramePipeline();
+	~FramePipeline();
+
+	/*
+	 * Start stage threads; frames waiting per stage limited to queue size
+	 */
+	void start(vector<function<void(FrameItem&)>> stages, int queueSize = 1);
+
+	/*
+	 * Hand over frame to first stage; blocks while its queue is full. Passes on error of any stage
+	 */
+	void push(FrameItem& item);
+
+	/*
+	 * Wait for frames in flight to be processed and stop stage threads. Passes on error of any stage
+	 */
+	void finish();
+
+	/*
+	 * Stop stage threads, discarding frames in flight
+	 */
+	void abort();
+	int getStageCount();
+
+private:
+	vector<function<void(FrameItem&)>> stages;
+	vector<FrameQueue*> queues;
+	vector<std::thread*> threads;
+	mutex errorMutex;
+	exception_ptr error = nullptr;
+
+	void stageThreadMethod(int stagei);
+	void join();
+	void checkError();
+};
@@ -0,0 +1,106 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include "FrameQueue.h"
+
+
+FrameQueue::FrameQueue() {
+}
+
+void FrameQueue::reset(int maxSize) {
+	lock_guard<mutex> lock(queueMutex);
+	items.clear();
+	error = nullptr;
+	this->maxSize = (maxSize > 0) ? maxSize : 1;
+	finished = false;
+	aborted = false;
+}
+
+bool FrameQueue::push(FrameItem& item) {
+	unique_lock<mutex> lock(queueMutex);
+	notFull.wait(lock, [this] { return aborted || items.size() < maxSize; });
+	if (aborted) {
+		return false;
+	}
+	items.push_back(item);
+	lock.unlock();
+	notEmpty.notify_one();
+	return true;
+}
+
+int FrameQueue::pushDrop(FrameItem& item, bool keepLatest) {
+	int ndropped = 0;
+	{
+		lock_guard<mutex> lock(queueMutex);
+		if (aborted) {
+			return 0;
+		}
+		if (keepLatest) {
+			ndropped = (int)items.size();
+			items.clear();
+		} else {
+			while (items.size() >= maxSize) {
+				items.pop_front();
+				ndropped++;
+			}
+		}
+		items.push_back(item);
+	}
+	notEmpty.notify_one();
+	return ndropped;
+}
+
+bool FrameQueue::pop(FrameItem& item) {
+	unique_lock<mutex> lock(queueMutex);
+	notEmpty.wait(lock, [this] { return aborted || finished || !items.empty(); });
+	if (aborted || items.empty()) {
+		return false;
+	}
+	item = items.front();
+	items.pop_front();
+	lock.unlock();
+	notFull.notify_one();
+	return true;
+}
+
+void FrameQueue::finish(exception_ptr error) {
+	{
+		lock_guard<mutex> lock(queueMutex);
+		this->error = error;
+		finished = true;
+	}
+	notEmpty.notify_all();
+}
+
+void FrameQueue::abort() {
+	{
+		lock_guard<mutex> lock(queueMutex);
+		items.clear();
+		aborted = true;
+	}
+	notFull.notify_all();
+	notEmpty.notify_all();
+}
+
+void FrameQueue::checkError() {
+	exception_ptr error0;
+	{
+		lock_guard<mutex> lock(queueMutex);
+		error0 = error;
+		error = nullptr;
+	}
+	if (error0) {
+		rethrow_exception(error0);
+	}
+}
+
+int FrameQueue::size() {
+	lock_guard<mutex> lock(queueMutex);
+	return (int)items.size();
+}
@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <opencv2/opencv.hpp>
+
+using namespace std;
+using namespace cv;
+
+
+/*
+ * Frame with its source frame number, as handed over between threads
+ */
+
+class FrameItem
+{
+public:
+	Mat image;
+	int framei = 0;
+	double time = 0;
+	string label = "";
+	int dropped = 0;
+	vector<Mat> images;		// pipeline: stored images used by next stages
+};
+
+
+/*
+ * Bounded frame queue between a producer (decoder) thread and the consumer (script) thread
+ */
+
+class FrameQueue
+{
+public:
+	FrameQueue();
+	void reset(int maxSize = 1);
+
+	/*
+	 * Producer: blocks while full; returns false if aborted by consumer
+	 */
+	bool push(FrameItem& item);
+
+	/*
+	 * Producer (live source): never blocks; when full drops oldest frame, or with keepLatest all queued frames. Returns number of frames dropped
+	 */
+	int pushDrop(FrameItem& item, bool keepLatest = false);
+
+	/*
+	 * Consumer: blocks while empty; returns false when producer finished and queue is empty
+	 */
+	bool pop(FrameItem& item);
+
+	/*
+	 * Producer finished (optionally with error to pass on to consumer)
+	 */
+	void finish(exception_ptr error = nullptr);
+
+	/*
+	 * Consumer stopped; release waiting producer
+	 */
+	void abort();
+
+	void checkError();
+	int size();
+
+private:
+	deque<FrameItem> items;
+	mutex queueMutex;
+	condition_variable notEmpty, notFull;
+	exception_ptr error = nullptr;
+	int maxSize = 1;
+	bool finished = false;
+	bool aborted = false;
+};
@@ -54,3 +54,23 @@ void FrameSource::calcFrameParams(string start, string length, double fps, int i
 		this->interval = 1;
 	}
 }
+
+int FrameSource::getStart() {
+	return start;
+}
+
+int FrameSource::getEnd() {
+	return end;
+}
+
+int FrameSource::getInterval() {
+	return interval;
+}
+
+double FrameSource::getFrameTime() {
+	return -1;
+}
+
+int FrameSource::getDroppedFrames() {
+	return 0;
+}
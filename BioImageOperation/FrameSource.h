@@ -28,9 +28,11 @@ protected:
 	double fps = 1;
 
 public:
+	virtual ~FrameSource() {}
 	virtual void reset() = 0;
 	virtual bool init(string basepath, string filepath, int apiCode, string codecs = "", string start = "", string length = "",
-					  double fps = 1, int interval = 1, int total = 0, int width = 0, int height = 0) = 0;
+					  double fps = 1, int interval = 1, int total = 0, int width = 0, int height = 0, int prefetch = 0, int dropMode = 0,
+					  bool cache = false, int colorMode = -1, double timeout = 0) = 0;
 	virtual bool getNextImage(Mat* image) = 0;
 	virtual void close() = 0;
 
@@ -43,5 +45,15 @@ public:
 	virtual int getCurrentFrame() = 0;
 	virtual int getTotalFrames() = 0;
 
+	/*
+	 * Live sources only: frame time [s] since opening (-1 if not available), and number of frames dropped
+	 */
+	virtual double getFrameTime();
+	virtual int getDroppedFrames();
+
+	int getStart();
+	int getEnd();
+	int getInterval();
+
 	void calcFrameParams(string start, string length, double fps, int interval, int total, int nframes);
 };
@@ -39,6 +39,7 @@ class ImageItem
 public:
 	Mat image;
 	string label;
+	bool stored = false;	// stored by script
 
 	ImageItem(string label);
 	ImageItem(Mat* image, string label);
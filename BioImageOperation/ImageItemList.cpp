@@ -21,27 +21,59 @@ ImageItemList::~ImageItemList() {
 }
 
 void ImageItemList::reset() {
+	for (int i = 0; i < size(); i++) {
+		delete at(i);
+	}
 	clear();
 }
 
-Mat* ImageItemList::getImage(string label, bool mustExist) {
-	if (label != "") {
-		for (int i = 0; i < size(); i++) {
-			if (at(i)->label == label) {
-				return &at(i)->image;
-			}
+int ImageItemList::getSlot(string label, bool store) {
+	int slot = -1;
+
+	if (label == "") {
+		throw invalid_argument("Invalid label");
+	}
+
+	for (int i = 0; i < size(); i++) {
+		if (at(i)->label == label) {
+			slot = i;
+			break;
 		}
 	}
-	if (mustExist) {
-		throw invalid_argument("Image not found: " + label);
+	if (slot < 0) {
+		slot = (int)size();
+		push_back(new ImageItem(label));
 	}
-	return nullptr;
+	if (store) {
+		at(slot)->stored = true;
+	}
+	return slot;
 }
 
-void ImageItemList::setImage(Mat* image, string label) {
-	ImageItem* item = nullptr;
+void ImageItemList::checkSlots() {
+	for (int i = 0; i < size(); i++) {
+		if (!at(i)->stored) {
+			throw invalid_argument("Image not found: " + at(i)->label);
+		}
+	}
+}
 
-	if (label == "") {
+Mat* ImageItemList::getImage(int slot, bool mustExist) {
+	if (slot >= 0 && slot < size()) {
+		if (!at(slot)->image.empty()) {
+			return &at(slot)->image;
+		}
+		if (mustExist) {
+			throw invalid_argument("Image not found: " + at(slot)->label);
+		}
+	} else if (mustExist) {
+		throw invalid_argument("Image not found");
+	}
+	return nullptr;
+}
+
+void ImageItemList::setImage(Mat* image, int slot) {
+	if (slot < 0 || slot >= size()) {
 		throw invalid_argument("Invalid label");
 	}
 
@@ -49,14 +81,36 @@ void ImageItemList::setImage(Mat* image, string label) {
 		throw invalid_argument("Invalid image");
 	}
 
-	for (int i = 0; i < size(); i++) {
-		if (at(i)->label == label) {
-			item = at(i);
-		}
-	}
-	if (!item) {
-		item = new ImageItem(label);
+	at(slot)->image = *image;
+}
+
+int ImageItemList::getSlotCount() {
+	return (int)size();
+}
+
+void ImageItemList::copySlots(ImageItemList* source) {
+	ImageItem* item;
+
+	reset();
+	for (int i = 0; i < source->size(); i++) {
+		item = new ImageItem(&source->at(i)->image, source->at(i)->label);
+		item->stored = source->at(i)->stored;
 		push_back(item);
 	}
-	item->image = *image;
+}
+
+void ImageItemList::getImages(vector<Mat>* images, vector<int>& slots) {
+	images->resize(size());
+	for (int slot : slots) {
+		// copy: stage overwrites its images with next frame
+		(*images)[slot] = at(slot)->image.clone();
+	}
+}
+
+void ImageItemList::setImages(vector<Mat>& images, vector<int>& slots) {
+	for (int slot : slots) {
+		if (slot < images.size()) {
+			at(slot)->image = images[slot];
+		}
+	}
 }
@@ -25,6 +25,28 @@ public:
 	~ImageItemList();
 
 	void reset();
-	Mat* getImage(string label, bool mustExist = true);
-	void setImage(Mat* image, string label);
+
+	/*
+	 * Resolve image label to slot when script is parsed, registering new label
+	 */
+	int getSlot(string label, bool store);
+
+	/*
+	 * Check all labels resolved are stored by script
+	 */
+	void checkSlots();
+	Mat* getImage(int slot, bool mustExist = true);
+	void setImage(Mat* image, int slot);
+	int getSlotCount();
+
+	/*
+	 * Pipeline stage: own copy of labels and images, for processing in separate thread
+	 */
+	void copySlots(ImageItemList* source);
+
+	/*
+	 * Pipeline stage: hand over (copies of) images of slots to next stage
+	 */
+	void getImages(vector<Mat>* images, vector<int>& slots);
+	void setImages(vector<Mat>& images, vector<int>& slots);
 };
@@ -19,16 +19,22 @@ ImageOutput::~ImageOutput() {
 }
 
 void ImageOutput::reset() {
+	close();
 	outputPath.reset();
 	start = 0;
 	end = 0;
 	filei = 0;
+	queue = 0;
+	statistics = "";
 }
 
-void ImageOutput::init(string basepath, string filepath, string defaultExtension, string start, string length, double fps0, string codecs) {
+void ImageOutput::init(string basepath, string filepath, string defaultExtension, string start, string length, double fps0, string codecs,
+					   int queue) {
 	reset();
 	int lengthi;
 
+	this->queue = queue;
+
 	if (!outputPath.setOutputPath(basepath, filepath, "", defaultExtension, true)) {
 		throw ios_base::failure("Unable to write to " + Util::extractFilePath(outputPath.initialPath));
 	}
@@ -47,11 +53,38 @@ void ImageOutput::init(string basepath, string filepath, string defaultExtension
 
 bool ImageOutput::writeImage(Mat* image) {
 	if (filei >= start && (filei < end || end == 0)) {
-		Util::saveImage(outputPath.createFilePath(filei), *image);
+		if (queue > 0) {
+			while (pendingWrites.size() >= queue) {
+				waitPendingWrite();
+			}
+			// file name set here, keeping numbering in order; own copy as script image buffers are reused
+			pendingWrites.push_back(async(launch::async, Util::saveImage, outputPath.createFilePath(filei), image->clone()));
+		} else {
+			Util::saveImage(outputPath.createFilePath(filei), *image);
+		}
 	}
 	filei++;
 	return true;
 }
 
+void ImageOutput::waitPendingWrite() {
+	future<void> pendingWrite = move(pendingWrites.front());
+	pendingWrites.pop_front();
+	// pass on any write error
+	pendingWrite.get();
+}
+
 void ImageOutput::close() {
+	// finish all pending writes
+	while (!pendingWrites.empty()) {
+		try {
+			waitPendingWrite();
+		} catch (exception& e) {
+			statistics += "Error writing image: " + string(e.what()) + "\n";
+		}
+	}
+}
+
+string ImageOutput::getStatistics() {
+	return statistics;
 }
@@ -8,6 +8,8 @@
  *****************************************************************************/
 
 #pragma once
+#include <deque>
+#include <future>
 #include "FrameOutput.h"
 #include "NumericPath.h"
 
@@ -24,10 +26,22 @@ public:
 	int end;
 	int filei = 0;
 
+	int queue = 0;
+	deque<future<void>> pendingWrites;
+	string statistics = "";
+
 	ImageOutput();
 	~ImageOutput();
 	void reset();
-	void init(string basepath, string filepath, string defaultExtension = "", string start = "", string length = "", double fps0 = 1, string codecs = "");
+	void init(string basepath, string filepath, string defaultExtension = "", string start = "", string length = "", double fps0 = 1, string codecs = "",
+			  int queue = 0);
 	bool writeImage(Mat* image);
+
+	/*
+	 * Queue mode: write (encode) images in parallel, up to queue size in progress
+	 */
+	void waitPendingWrite();
+
 	void close();
+	string getStatistics();
 };
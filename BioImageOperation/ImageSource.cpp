@@ -27,22 +27,45 @@ void ImageSource::reset() {
 	interval = 1;
 	width = 0;
 	height = 0;
+	stopLoaderThreads();
+	prefetch = 0;
+	timeout = 0;
+	watcher.close();
 }
 
 bool ImageSource::init(string basepath, string filepath, int apiCode, string codecs, string start, string length,
-					   double fps0, int interval, int total, int width, int height) {
+					   double fps0, int interval, int total, int width, int height, int prefetch, int dropMode,
+					   bool cache, int colorMode, double timeout) {
 	reset();
 
+	this->timeout = timeout;
+	if (timeout > 0) {
+		// start watching before listing existing files, so none are missed
+		watcher.open(Util::combinePath(basepath, filepath));
+	}
+
 	sourcePath.setInputPath(basepath, filepath);
 
 	nfiles = sourcePath.getFileCount();
-	if (nfiles == 0) {
+	if (timeout > 0) {
+		for (string filename : sourcePath.inputFilenames) {
+			watcher.addKnown(filename);
+		}
+		// total number of files unknown
+		nfiles = 0;
+	} else if (nfiles == 0) {
 		throw ios_base::failure("File(s) not found: " + sourcePath.templatePath);
 	}
 
 	calcFrameParams(start, length, fps, interval, total, nfiles);
 
 	sourcePath.resetFilePath();
+	filei = this->start;
+
+	this->prefetch = prefetch;
+	if (prefetch > 0 && timeout <= 0) {
+		startLoaderThreads();
+	}
 
 	return open();
 }
@@ -52,11 +75,38 @@ bool ImageSource::open() {
 }
 
 void ImageSource::close() {
+	stopLoaderThreads();
+	watcher.close();
 }
 
 bool ImageSource::getNextImage(Mat* image) {
+	FrameItem item;
 	bool more = false;
-	string filename = sourcePath.createFilePath(filei);
+	string filename;
+
+	if (timeout > 0) {
+		return getNextStreamImage(image);
+	}
+
+	if (!loaderThreads.empty()) {
+		if (frameQueue.pop(item)) {
+			*image = item.image;
+			width = image->cols;
+			height = image->rows;
+			label = item.label;
+			filei = item.framei + interval;
+			more = (filei < end);
+		} else {
+			// pass on any error from loader threads
+			frameQueue.checkError();
+		}
+		if (!more) {
+			close();
+		}
+		return more;
+	}
+
+	filename = sourcePath.createFilePath(filei);
 
 	label = Util::extractFileTitle(filename);
 
@@ -78,6 +128,115 @@ bool ImageSource::getNextImage(Mat* image) {
 	return more;
 }
 
+bool ImageSource::getNextStreamImage(Mat* image) {
+	string filename;
+
+	while (filei >= sourcePath.getFileCount() && (end <= 0 || filei < end)) {
+		if (!watcher.getNextFilename(&filename, timeout)) {
+			break;
+		}
+		sourcePath.addInputFilename(filename);
+	}
+
+	if (filei >= sourcePath.getFileCount() || (end > 0 && filei >= end)) {
+		close();
+		return false;
+	}
+
+	filename = sourcePath.createFilePath(filei);
+	label = Util::extractFileTitle(filename);
+	*image = Util::loadImage(filename);
+	if (!Util::isValidImage(image)) {
+		throw ios_base::failure("Image load error " + filename);
+	}
+	width = image->cols;
+	height = image->rows;
+	filei += interval;
+	return true;
+}
+
+void ImageSource::startLoaderThreads() {
+	int nthreads = min(prefetch, max((int)std::thread::hardware_concurrency(), 1));
+
+	frameQueue.reset(prefetch);
+	loadi = filei;
+	pushi = filei;
+	loaderStopping = false;
+	if (loadi >= end) {
+		frameQueue.finish();
+	}
+	for (int threadi = 0; threadi < nthreads; threadi++) {
+		loaderThreads.push_back(new std::thread(&ImageSource::loaderThreadMethod, this));
+	}
+}
+
+void ImageSource::stopLoaderThreads() {
+	{
+		lock_guard<mutex> lock(loaderMutex);
+		loaderStopping = true;
+	}
+	loaderTurn.notify_all();
+	frameQueue.abort();
+
+	for (std::thread* thread : loaderThreads) {
+		thread->join();
+		delete thread;
+	}
+	loaderThreads.clear();
+}
+
+void ImageSource::loaderThreadMethod() {
+	unique_lock<mutex> lock(loaderMutex);
+	FrameItem item;
+	exception_ptr error;
+	string filename;
+	bool frameOk;
+
+	while (!loaderStopping && loadi < end) {
+		item.framei = loadi;
+		loadi += interval;
+		filename = sourcePath.createFilePath(item.framei);
+		lock.unlock();
+
+		error = nullptr;
+		frameOk = (filename != "");
+		if (frameOk) {
+			try {
+				item.image = Util::loadImage(filename);
+				if (!Util::isValidImage(&item.image)) {
+					throw ios_base::failure("Image load error " + filename);
+				}
+				item.label = Util::extractFileTitle(filename);
+			} catch (...) {
+				error = current_exception();
+			}
+		}
+
+		// hand over in file order: wait for preceding files
+		lock.lock();
+		loaderTurn.wait(lock, [&] { return loaderStopping || pushi == item.framei; });
+		if (loaderStopping) {
+			break;
+		}
+		if (!frameOk || error) {
+			// stop at missing file or error, after all preceding images
+			loaderStopping = true;
+			frameQueue.finish(error);
+		} else {
+			// only thread in turn pushes; blocks while queue full
+			lock.unlock();
+			frameQueue.push(item);
+			lock.lock();
+			pushi += interval;
+			if (pushi >= end) {
+				frameQueue.finish();
+			}
+		}
+		item.image.release();
+		loaderTurn.notify_all();
+	}
+}
+
 int ImageSource::getWidth() {
 	return width;
 }
@@ -103,5 +262,8 @@ int ImageSource::getCurrentFrame() {
 }
 
 int ImageSource::getTotalFrames() {
+	if (end <= 0) {
+		return 0;
+	}
 	return end - start;
 }
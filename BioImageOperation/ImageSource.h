@@ -8,9 +8,15 @@
  *****************************************************************************/
 
 #pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <opencv2/opencv.hpp>
 #include "FrameSource.h"
+#include "FrameQueue.h"
 #include "NumericPath.h"
+#include "DirectoryWatcher.h"
 
 using namespace std;
 using namespace cv;
@@ -30,13 +36,39 @@ public:
 	int nfiles = 0;
 	int filei = 0;
 
+	int prefetch = 0;
+	vector<std::thread*> loaderThreads;
+	FrameQueue frameQueue;
+	mutex loaderMutex;
+	condition_variable loaderTurn;
+	int loadi = 0;				// next file to load
+	int pushi = 0;				// next file to hand over (in order)
+	bool loaderStopping = false;
+
+	double timeout = 0;
+	DirectoryWatcher watcher;
+
 	ImageSource();
 	~ImageSource();
 	void reset();
 	bool init(string basepath, string filepath, int apiCode, string codecs = "", string start = "", string length = "",
-			  double fps = 1, int interval = 1, int total = 0, int width = 0, int height = 0);
+			  double fps = 1, int interval = 1, int total = 0, int width = 0, int height = 0, int prefetch = 0, int dropMode = 0,
+			  bool cache = false, int colorMode = -1, double timeout = 0);
 	bool open();
 	bool getNextImage(Mat* image);
+
+	/*
+	 * Streaming mode: wait for new files written to folder, until none for timeout [s]
+	 */
+	bool getNextStreamImage(Mat* image);
+
+	/*
+	 * Prefetch mode: fixed pool of loader threads load upcoming images in parallel, handed over in order
+	 */
+	void startLoaderThreads();
+	void stopLoaderThreads();
+	void loaderThreadMethod();
+
 	void close();
 
 	int getWidth();
@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #include <math.h>
+#include <algorithm>
 #include "ImageTracker.h"
 #include "GreedyAlgorithm.h"
 #include "HungarianAlgorithm.h"
@@ -659,175 +660,246 @@ string ImageTracker::getInfo() {
 	return info;
 }
 
-void ImageTracker::saveClusters(string filename, int frame, double time, SaveFormat saveFormat, bool outputContour) {
+double ImageTracker::getMaxMoveDistance() {
+	return trackingParams.maxMove.getMax() * pixelSize;
+}
+
+void ImageTracker::saveClusters(string filename, int frame, double time, SaveFormat saveFormat, bool outputContour, ContourFormat contourFormat) {
 	OutputStream* clusterStream = nullptr;
-	string csv = "";
+	double values[Cluster::nvalues];
 	string sfilename;
 	NumericPath filepath;
 	int dcolset;
+	vector<pair<int, Cluster*>> labelClusters;
 	int colseti = 0;
-	int maxcluster = 0;
-	string maincols = Cluster::getCsvHeader(outputContour);
+	string maincols = Cluster::getCsvHeader(outputContour, contourFormat);
 	int nmaincols = (int)Util::split(maincols, ",").size();
 	string header = "frame,time," + maincols + "\n";
+	vector<int> trackLabels;
 
 	if (saveFormat == SaveFormat::Split) {
 		filepath.setOutputPath(filename);
+	} else if (saveFormat == SaveFormat::Binary) {
+		initColumnStream(&clusterColumnStream, filename, Cluster::getCsvHeader(), ColumnType::Int32List);
 	} else {
 		clusterStream = clusterStreams.get(filename, header);
 	}
 
 	if (clusterParamsFinalised) {
 		if (saveFormat == SaveFormat::ByLabel) {
+			// label order (stable: same label in order of clusters); column set position follows label
 			for (Cluster* cluster : clusters) {
-				maxcluster = max(cluster->getInitialLabel(), maxcluster);
+				if (cluster->getInitialLabel() >= 0) {
+					labelClusters.push_back({ cluster->getInitialLabel(), cluster });
+				}
 			}
-			csv += Util::format("{0},{1}", frame, time);
-			for (int clusteri = 0; clusteri <= maxcluster; clusteri++) {
-				for (Cluster* cluster : clusters) {
-					if (cluster->getInitialLabel() == clusteri) {
-						dcolset = clusteri - colseti;
-						if (dcolset > 0) {
-							csv += string(dcolset * nmaincols, ',');
-							colseti = clusteri;
-						}
-						csv += "," + cluster->getCsv(outputContour);
-						colseti++;
-					}
+			stable_sort(labelClusters.begin(), labelClusters.end(),
+						[](const pair<int, Cluster*>& item1, const pair<int, Cluster*>& item2) { return item1.first < item2.first; });
+
+			clusterStream->addValue(frame);
+			clusterStream->addValue(time);
+			for (auto& labelCluster : labelClusters) {
+				dcolset = labelCluster.first - colseti;
+				if (dcolset > 0) {
+					clusterStream->addEmpty(dcolset * nmaincols);
+					colseti = labelCluster.first;
 				}
+				labelCluster.second->writeCsv(clusterStream, outputContour, contourFormat);
+				colseti++;
 			}
-			csv += "\n";
+			clusterStream->endRow();
 		} else if (saveFormat == SaveFormat::ByTime) {
 			for (Cluster* cluster : clusters) {
-				csv += Util::format("%d,%f,%s\n", frame, time, cluster->getCsv(outputContour).c_str());
+				clusterStream->addValue(frame);
+				clusterStream->addValue(time);
+				cluster->writeCsv(clusterStream, outputContour, contourFormat);
+				clusterStream->endRow();
 			}
 		} else if (saveFormat == SaveFormat::Split) {
 			for (Cluster* cluster : clusters) {
-				csv = Util::format("%d,%f,%s\n", frame, time, cluster->getCsv(outputContour).c_str());
 				sfilename = filepath.createFilePath(cluster->getInitialLabel());
 				clusterStream = clusterStreams.get(sfilename, header);
-				clusterStream->write(csv);
+				clusterStream->addValue(frame);
+				clusterStream->addValue(time);
+				cluster->writeCsv(clusterStream, outputContour, contourFormat);
+				clusterStream->endRow();
+			}
+		} else if (saveFormat == SaveFormat::Binary) {
+			for (Cluster* cluster : clusters) {
+				clusterColumnStream.add(frame);
+				clusterColumnStream.add(time);
+				// all track labels (merged cluster), as CSV output
+				trackLabels.clear();
+				for (Track* track : cluster->assignedTracks) {
+					if (track->label >= 0) {
+						trackLabels.push_back(track->label);
+					}
+				}
+				clusterColumnStream.addList(trackLabels);
+				clusterColumnStream.add(cluster->clusterLabel);
+				clusterColumnStream.add(cluster->isMerged());
+				cluster->getValues(values);
+				for (double value : values) {
+					clusterColumnStream.add(value);
+				}
 			}
-		}
-
-		if (saveFormat != SaveFormat::Split) {
-			clusterStream->write(csv);
 		}
 	}
 }
 
-void ImageTracker::saveTracks(string filename, int frame, double time, SaveFormat saveFormat, bool outputContour) {
+void ImageTracker::saveTracks(string filename, int frame, double time, SaveFormat saveFormat, bool outputContour, ContourFormat contourFormat) {
 	OutputStream* trackStream = nullptr;
 	Cluster* cluster = nullptr;
-	string csv = "";
+	double values[Track::nvalues];
 	string sfilename;
 	NumericPath filepath;
-	string maincols = Track::getCsvHeader(outputContour);
+	string maincols = Track::getCsvHeader(outputContour, contourFormat);
 	int nmaincols = (int)Util::split(maincols, ",").size();
-	int maxtrack = 0;
+	vector<pair<int, Track*>> labelTracks;
+	map<Track*, Cluster*> trackClusters;
 	int colseti = 0;
 	int dcolset;
 	string header = "frame,time," + maincols + "\n";
 
 	if (saveFormat == SaveFormat::Split) {
 		filepath.setOutputPath(filename);
+	} else if (saveFormat == SaveFormat::Binary) {
+		initColumnStream(&trackColumnStream, filename, Track::getCsvHeader(), ColumnType::Int32);
 	} else {
 		trackStream = trackStreams.get(filename, header);
 	}
 
 	if (trackParamsFinalised) {
 		if (saveFormat == SaveFormat::ByLabel) {
+			// label order (stable: same label in order of tracks); column set position follows label
 			for (Track* track : tracks) {
-				if (track->isActive()) {
-					maxtrack = max(track->label, maxtrack);
+				if (track->isActive() && track->label >= 0) {
+					labelTracks.push_back({ track->label, track });
 				}
 			}
-			csv += Util::format("%d,%f", frame, time);
-			for (int tracki = 0; tracki <= maxtrack; tracki++) {
-				for (Track* track : tracks) {
-					if (track->label == tracki) {
-						if (track->isActive()) {
-							dcolset = tracki - colseti;
-							if (dcolset > 0) {
-								csv += string(dcolset * nmaincols, ',');
-								colseti = tracki;
-							}
-							if (outputContour) {
-								cluster = findTrackedCluster(track);
-							}
-							csv += "," + track->getCsv(outputContour, cluster);
-							colseti++;
-						}
-					}
+			stable_sort(labelTracks.begin(), labelTracks.end(),
+						[](const pair<int, Track*>& item1, const pair<int, Track*>& item2) { return item1.first < item2.first; });
+
+			trackStream->addValue(frame);
+			trackStream->addValue(time);
+			for (auto& labelTrack : labelTracks) {
+				dcolset = labelTrack.first - colseti;
+				if (dcolset > 0) {
+					trackStream->addEmpty(dcolset * nmaincols);
+					colseti = labelTrack.first;
+				}
+				if (outputContour) {
+					cluster = findTrackedCluster(labelTrack.second, &trackClusters);
 				}
+				labelTrack.second->writeCsv(trackStream, outputContour, cluster, contourFormat);
+				colseti++;
 			}
-			csv += "\n";
+			trackStream->endRow();
 		} else if (saveFormat == SaveFormat::ByTime) {
 			for (Track* track : tracks) {
 				if (track->isActive()) {
 					if (outputContour) {
-						cluster = findTrackedCluster(track);
+						cluster = findTrackedCluster(track, &trackClusters);
 					}
-					csv += Util::format("%d,%f,%s\n", frame, time, track->getCsv(outputContour, cluster).c_str());
+					trackStream->addValue(frame);
+					trackStream->addValue(time);
+					track->writeCsv(trackStream, outputContour, cluster, contourFormat);
+					trackStream->endRow();
 				}
 			}
 		} else if (saveFormat == SaveFormat::Split) {
 			for (Track* track : tracks) {
 				if (track->isActive()) {
 					if (outputContour) {
-						cluster = findTrackedCluster(track);
+						cluster = findTrackedCluster(track, &trackClusters);
 					}
-					csv = Util::format("%d,%f,%s\n", frame, time, track->getCsv(outputContour, cluster).c_str());
 					sfilename = filepath.createFilePath(track->label);
 					trackStream = trackStreams.get(sfilename, header);
-					trackStream->write(csv);
+					trackStream->addValue(frame);
+					trackStream->addValue(time);
+					track->writeCsv(trackStream, outputContour, cluster, contourFormat);
+					trackStream->endRow();
+				}
+			}
+		} else if (saveFormat == SaveFormat::Binary) {
+			for (Track* track : tracks) {
+				if (track->isActive()) {
+					trackColumnStream.add(frame);
+					trackColumnStream.add(time);
+					trackColumnStream.add(track->label);
+					trackColumnStream.add(track->clusterLabel);
+					trackColumnStream.add(track->isMerged);
+					track->getValues(values);
+					for (double value : values) {
+						trackColumnStream.add(value);
+					}
 				}
 			}
 		}
+	}
+}
 
-		if (saveFormat != SaveFormat::Split) {
-			trackStream->write(csv);
-		}
+void ImageTracker::initColumnStream(ColumnStream* columnStream, string filename, string maincols, ColumnType labelType) {
+	vector<string> names = Util::split("frame,time," + maincols, ",");
+	vector<ColumnType> types = { ColumnType::Int32, ColumnType::Float64, labelType, ColumnType::Int32, ColumnType::Bool };
+
+	if (columnStream->types.empty()) {
+		types.resize(names.size(), ColumnType::Float64);
+		columnStream->init(filename, names, types);
 	}
 }
 
 void ImageTracker::savePaths(string filename, int frame, double time) {
-	string s = "";
-
 	pathStream.init(filename, "frame,time,label,created,usage,last use, total use,x,y\n");
 
 	if (trackParamsFinalised) {
 		for (PathNode* node : pathNodes) {
-			s += Util::format("%d,%f,%d,%d,%d,%d,%f,%f\n", frame, time, node->label, node->created, node->accumUsage, node->lastUse, node->totalUse, node->x, node->y);
+			pathStream.addValue(frame);
+			pathStream.addValue(time);
+			pathStream.addValue(node->label);
+			pathStream.addValue(node->created);
+			pathStream.addValue(node->accumUsage);
+			pathStream.addValue(node->lastUse);
+			pathStream.addValue(node->totalUse);
+			pathStream.addValue(node->x);
+			pathStream.addValue(node->y);
+			pathStream.endRow();
 		}
-		pathStream.write(s);
 	}
 }
 
 void ImageTracker::saveTrackInfo(string filename, int frame, double time) {
-	string s = "";
-
 	trackInfoStream.init(filename, "Frame,Time,Clusters,Tracks,Active tracks,Match rate,Match factor,Distance,Lifetime\n");
 
 	if (clusterParamsFinalised) {
-		s += Util::format("%d,%f,%d", frame, time, clusters.size());
+		trackInfoStream.addValue(frame);
+		trackInfoStream.addValue(time);
+		trackInfoStream.addValue((int)clusters.size());
 		if (trackParamsFinalised) {
-			s += Util::format(",%d,%d,%f,%f,%f,%f",
-				tracks.size(), trackingStats.trackLifetime.n, trackingStats.trackMatchRate.getAverage(), trackingStats.trackMatchFactor.getAverage(), trackingStats.trackDistance.getAverage(), trackingStats.trackLifetime.getAverage());
+			trackInfoStream.addValue((int)tracks.size());
+			trackInfoStream.addValue(trackingStats.trackLifetime.n);
+			trackInfoStream.addValue(trackingStats.trackMatchRate.getAverage());
+			trackInfoStream.addValue(trackingStats.trackMatchFactor.getAverage());
+			trackInfoStream.addValue(trackingStats.trackDistance.getAverage());
+			trackInfoStream.addValue(trackingStats.trackLifetime.getAverage());
 		}
-		s += "\n";
-		trackInfoStream.write(s);
+		trackInfoStream.endRow();
 	}
 }
 
-Cluster* ImageTracker::findTrackedCluster(Track* targetTrack) {
-	for (Cluster* cluster : clusters) {
-		for (Track* track : cluster->assignedTracks) {
-			if (track == targetTrack) {
-				return cluster;
+Cluster* ImageTracker::findTrackedCluster(Track* targetTrack, map<Track*, Cluster*>* trackClusters) {
+	if (trackClusters->empty()) {
+		// index once: first cluster assigned to track
+		for (Cluster* cluster : clusters) {
+			for (Track* track : cluster->assignedTracks) {
+				trackClusters->emplace(track, cluster);
 			}
 		}
 	}
+	auto item = trackClusters->find(targetTrack);
+	if (item != trackClusters->end()) {
+		return item->second;
+	}
 	return nullptr;
 }
 
@@ -836,4 +908,6 @@ void ImageTracker::close() {
 	trackStreams.close();
 	pathStream.closeStream();
 	trackInfoStream.closeStream();
+	clusterColumnStream.closeStream();
+	trackColumnStream.closeStream();
 }
@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #pragma once
+#include <map>
 #include <opencv2/opencv.hpp>
 #include "Observer.h"
 #include "TrackingAlgorithm.h"
@@ -22,6 +23,7 @@
 #include "Cluster.h"
 #include "OutputStream.h"
 #include "OutputStreams.h"
+#include "ColumnStream.h"
 
 using namespace std;
 using namespace cv;
@@ -61,6 +63,7 @@ public:
 	Point countPosition;
 	OutputStreams clusterStreams, trackStreams;
 	OutputStream pathStream, trackInfoStream;
+	ColumnStream clusterColumnStream, trackColumnStream;
 	Mat clusterLabelImage, clusterRoiImage;
 	Mat1i clusterStats;
 	Mat1d clusterCentroids;
@@ -164,14 +167,24 @@ public:
 	 */
 	string getInfo();
 
+	/*
+	 * Max distance tracks move between frames, in output units (0: not known yet)
+	 */
+	double getMaxMoveDistance();
+
 	/*
 	 * Save routines
 	 */
-	void saveClusters(string fileName, int frame, double time, SaveFormat byLabel, bool outputContour);
-	void saveTracks(string fileName, int frame, double time, SaveFormat byLabel, bool outputContour);
+	void saveClusters(string fileName, int frame, double time, SaveFormat byLabel, bool outputContour, ContourFormat contourFormat = ContourFormat::Points);
+	void saveTracks(string fileName, int frame, double time, SaveFormat byLabel, bool outputContour, ContourFormat contourFormat = ContourFormat::Points);
+
+	/*
+	 * Binary columnar output: frame, time, labels and numeric values (no contour)
+	 */
+	void initColumnStream(ColumnStream* columnStream, string filename, string maincols, ColumnType labelType);
 	void savePaths(string fileName, int frame, double time);
 	void saveTrackInfo(string fileName, int frame, double time);
-	Cluster* findTrackedCluster(Track* targetTrack);
+	Cluster* findTrackedCluster(Track* targetTrack, map<Track*, Cluster*>* trackClusters);
 
 	/*
 	 * Ensure closing & flushing any open streams
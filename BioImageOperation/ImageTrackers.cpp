@@ -11,7 +11,11 @@
 
 
 ImageTrackers::~ImageTrackers() {
-	close();
+	try {
+		close();
+	} catch (exception& e) {
+		cerr << e.what() << endl;
+	}
 	reset();
 }
 
@@ -29,6 +33,8 @@ void ImageTrackers::close() {
 }
 
 ImageTracker* ImageTrackers::get(string id, TrackingMethod trackingMethod, double fps, double pixelSize, double windowSize, Observer* observer) {
+	lock_guard<mutex> lock(trackersMutex);
+
 	for (ImageTracker* tracker : *this) {
 		if (tracker->id == id) {
 			return tracker;
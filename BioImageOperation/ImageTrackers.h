@@ -9,6 +9,7 @@
 
 #pragma once
 #include <vector>
+#include <mutex>
 #include "ImageTracker.h"
 
 using namespace std;
@@ -25,4 +26,7 @@ public:
 	void reset();
 	void close();
     ImageTracker* get(string id, TrackingMethod trackingMethod = TrackingMethod::Any, double fps = 0, double pixelSize = 1, double windowSize = 1, Observer* observer = nullptr);
+
+private:
+	mutex trackersMutex;	// trackers used by concurrent operations
 };
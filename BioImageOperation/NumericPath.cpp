@@ -9,6 +9,7 @@
 
 #include <filesystem>
 #include "NumericPath.h"
+#include "OutputCompressor.h"
 #include "Util.h"
 
 
@@ -55,10 +56,21 @@ bool NumericPath::setInputPath(string basepath, string templatePath) {
 	return set;
 }
 
+void NumericPath::addInputFilename(string filename) {
+	inputFilenames.push_back(filename);
+	totaln = (int)inputFilenames.size();
+	set = true;
+}
+
 bool NumericPath::setOutputPath(string templatePath) {
 	string extension = Util::extractFileExtension(templatePath);
 	string title = Util::extractFileTitle(templatePath);
 	string path = Util::extractFilePath(templatePath);
+	if (OutputCompressor::getCompressionType(templatePath) != CompressionType::None) {
+		// keep data extension with compression extension
+		extension = Util::extractFileExtension(title) + extension;
+		title = Util::extractFileTitle(title);
+	}
 	if (!Util::endsWith(title, "_")) {
 		templatePath = Util::combinePath(path, title + "_" + extension);
 	}
@@ -90,6 +102,10 @@ bool NumericPath::setOutputPath(string basepath, string templatePath, string ext
 	this->templatePath = templatePath;
 
 	extPos = (int)templatePath.find_last_of(".");
+	if (extPos >= 0 && OutputCompressor::getCompressionType(templatePath) != CompressionType::None) {
+		// data extension before compression extension
+		extPos -= (int)Util::extractFileExtension(Util::extractFileTitle(templatePath)).length();
+	}
 	if (extPos >= 0) {
 		extension = templatePath.substr(extPos);
 		numpos = extPos;
@@ -37,6 +37,7 @@ public:
 	void reset();
 	void resetFilePath();
 	bool setInputPath(string basepath, string templatePath);
+	void addInputFilename(string filename);
 	bool setOutputPath(string templatePath);
 	bool setOutputPath(string basepath, string templatePath, string extra="", string defaultExtension = "", bool lookForNum = false);
 	string createFilePath();
@@ -23,6 +23,7 @@ using namespace cv;
 class Observer
 {
 public:
+	virtual ~Observer() {}
 	virtual void requestPause() = 0;
 	virtual void setMode(int mode) = 0;
 	virtual void resetProgressTimer() = 0;
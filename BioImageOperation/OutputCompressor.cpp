@@ -0,0 +1,136 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+
+#include <stdexcept>
+#include <ios>
+#include "OutputCompressor.h"
+#include "Util.h"
+
+
+OutputCompressor::OutputCompressor() {
+}
+
+OutputCompressor::~OutputCompressor() {
+	close();
+}
+
+void OutputCompressor::init(string filename) {
+	close();
+	type = getCompressionType(filename);
+
+	switch (type) {
+	case CompressionType::Gzip:
+#ifdef HAVE_ZLIB
+		zstream = new z_stream();
+		// window bits + 16: gzip format
+		if (deflateInit2(zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+			close();
+			throw ios_base::failure("Unable to initialise gzip compression");
+		}
+#else
+		throw invalid_argument("Gzip compression not supported in this build: " + filename);
+#endif
+		break;
+
+	case CompressionType::Zstd:
+#ifdef HAVE_ZSTD
+		zstdContext = ZSTD_createCCtx();
+		if (!zstdContext) {
+			throw ios_base::failure("Unable to initialise zstd compression");
+		}
+		ZSTD_CCtx_setParameter(zstdContext, ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
+#else
+		throw invalid_argument("Zstd compression not supported in this build: " + filename);
+#endif
+		break;
+
+	default:
+		break;
+	}
+}
+
+void OutputCompressor::close() {
+#ifdef HAVE_ZLIB
+	if (zstream) {
+		deflateEnd(zstream);
+		delete zstream;
+		zstream = nullptr;
+	}
+#endif
+#ifdef HAVE_ZSTD
+	if (zstdContext) {
+		ZSTD_freeCCtx(zstdContext);
+		zstdContext = nullptr;
+	}
+#endif
+	type = CompressionType::None;
+	started = false;
+}
+
+void OutputCompressor::compress(const string& input, string* output, bool finish) {
+	size_t outputSize = 0;
+	bool done = false;
+
+	output->clear();
+	started = !finish;
+
+#ifdef HAVE_ZLIB
+	if (zstream) {
+		int result;
+
+		zstream->next_in = (Bytef*)input.data();
+		zstream->avail_in = (uInt)input.size();
+		while (!done) {
+			output->resize(outputSize + chunkSize);
+			zstream->next_out = (Bytef*)output->data() + outputSize;
+			zstream->avail_out = chunkSize;
+			result = deflate(zstream, finish ? Z_FINISH : Z_NO_FLUSH);
+			if (result == Z_STREAM_ERROR) {
+				throw ios_base::failure("Gzip compression error");
+			}
+			outputSize += chunkSize - zstream->avail_out;
+			done = finish ? (result == Z_STREAM_END) : (zstream->avail_out != 0);
+		}
+		if (finish) {
+			// start new gzip member for any further output
+			deflateReset(zstream);
+		}
+	}
+#endif
+#ifdef HAVE_ZSTD
+	if (zstdContext) {
+		ZSTD_inBuffer inBuffer = { input.data(), input.size(), 0 };
+		size_t remaining;
+
+		while (!done) {
+			output->resize(outputSize + chunkSize);
+			ZSTD_outBuffer outBuffer = { output->data() + outputSize, chunkSize, 0 };
+			remaining = ZSTD_compressStream2(zstdContext, &outBuffer, &inBuffer, finish ? ZSTD_e_end : ZSTD_e_continue);
+			if (ZSTD_isError(remaining)) {
+				throw ios_base::failure(string("Zstd compression error: ") + ZSTD_getErrorName(remaining));
+			}
+			outputSize += outBuffer.pos;
+			done = finish ? (remaining == 0) : (inBuffer.pos == inBuffer.size);
+		}
+	}
+#endif
+	output->resize(outputSize);
+}
+
+CompressionType OutputCompressor::getCompressionType(string filename) {
+	string extension = Util::toLower(Util::extractFileExtension(filename));
+
+	if (extension == ".gz") {
+		return CompressionType::Gzip;
+	} else if (extension == ".zst") {
+		return CompressionType::Zstd;
+	}
+	return CompressionType::None;
+}
@@ -0,0 +1,56 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+
+#pragma once
+#include <string>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include "Constants.h"
+
+using namespace std;
+
+
+/*
+ * Streaming compression of output (gzip/zstd), selected by file extension.
+ * Each finished part is a complete gzip member / zstd frame, so parts can be appended to existing file
+ */
+
+class OutputCompressor
+{
+public:
+	static const int chunkSize = 65536;
+
+	CompressionType type = CompressionType::None;
+	bool started = false;
+
+	OutputCompressor();
+	~OutputCompressor();
+	void init(string filename);
+	void close();
+
+	/*
+	 * Compress input to output; finish to complete part
+	 */
+	void compress(const string& input, string* output, bool finish);
+
+	static CompressionType getCompressionType(string filename);
+
+private:
+#ifdef HAVE_ZLIB
+	z_stream* zstream = nullptr;
+#endif
+#ifdef HAVE_ZSTD
+	ZSTD_CCtx* zstdContext = nullptr;
+#endif
+};
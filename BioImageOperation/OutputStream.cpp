@@ -8,11 +8,15 @@
  *****************************************************************************/
 
 #include <filesystem>
+#include <charconv>
 #include "OutputStream.h"
 #include "Util.h"
 #include "Constants.h"
 
 
+atomic<size_t> OutputStream::totalBuffered = 0;
+
+
 OutputStream::OutputStream(string filename, string header) {
 	if (filename != "") {
 		init(filename, header);
@@ -24,21 +28,34 @@ OutputStream::~OutputStream() {
 }
 
 void OutputStream::reset() {
-	closeStream();
+	try {
+		closeStream();
+		closeFile();
+	} catch (exception& e) {
+		// also called from destructor: report write error, not passed on
+		errorMode = true;
+		cerr << e.what() << endl;
+	}
 	filename = "";
 	clearBuffer();
+	compressor.close();
+	rowStart = true;
+	binary = false;
 	created = false;
 	errorMode = false;
 }
 
 void OutputStream::clearBuffer() {
-	buffer.str("");
+	buffer.clear();
+	updateBuffered();
 }
 
-void OutputStream::init(string filename, string header) {
+void OutputStream::init(string filename, string header, bool binary) {
 	if (!created) {
-		exceptions(ofstream::failbit | ofstream::badbit);
+		file.exceptions(ofstream::failbit | ofstream::badbit);
 		this->filename = filename;
+		this->binary = binary;
+		compressor.init(filename);
 		if (header != "") {
 			write(header);
 		}
@@ -47,49 +64,162 @@ void OutputStream::init(string filename, string header) {
 
 void OutputStream::write(string output) {
 	if (output != "") {
-		buffer << output;
-		if (created && buffer.tellp() < Constants::maxLogBuffer) {
+		buffer += output;
+		updateBuffered();
+		if (created && buffer.size() < Constants::maxLogBuffer) {
 			return;
 		}
 	}
-	if (buffer.tellp() != 0) {
-		writeToFile();
+	if (!buffer.empty()) {
+		startFlush();
 	}
 }
 
-void OutputStream::writeToFile() {
-	ios_base::openmode openMode = std::ios_base::out;
-	if (created) {
-		// append if already created
-		openMode |= std::ios_base::app;
-	} else {
-		// check/create path
-		filesystem::path path(filename);
-		filesystem::path parent = path.parent_path();
-		if (!filesystem::is_directory(parent)) {
-			filesystem::create_directories(parent);
+void OutputStream::addValue(int value) {
+	startValue();
+	appendNumber(value);
+}
+
+void OutputStream::addValue(double value) {
+	startValue();
+	appendNumber(value);
+}
+
+void OutputStream::addValue(bool value) {
+	startValue();
+	buffer += value ? "true" : "false";
+}
+
+void OutputStream::addValue(const string& value) {
+	startValue();
+	buffer += value;
+}
+
+void OutputStream::addEmpty(int n) {
+	for (int i = 0; i < n; i++) {
+		startValue();
+	}
+}
+
+void OutputStream::endRow() {
+	buffer += '\n';
+	rowStart = true;
+	updateBuffered();
+	if (!created || buffer.size() >= Constants::maxLogBuffer) {
+		startFlush();
+	}
+}
+
+void OutputStream::startValue() {
+	if (!rowStart) {
+		buffer += ',';
+	}
+	rowStart = false;
+}
+
+void OutputStream::appendNumber(int value) {
+	char chars[16];
+	to_chars_result result = to_chars(chars, chars + sizeof(chars), value);
+	buffer.append(chars, result.ptr);
+}
+
+void OutputStream::appendNumber(double value) {
+	// fixed 6 decimals, as printf %f
+	char chars[Constants::maxNumberLength];
+	to_chars_result result = to_chars(chars, chars + sizeof(chars), value, chars_format::fixed, 6);
+	buffer.append(chars, result.ptr);
+}
+
+void OutputStream::appendChar(char c) {
+	buffer += c;
+}
+
+void OutputStream::updateBuffered() {
+	// buffer only grows until flushed (or cleared)
+	totalBuffered += buffer.size() - bufferedSize;
+	bufferedSize = buffer.size();
+}
+
+void OutputStream::startFlush() {
+	waitFlush();
+	// previous buffer written (and empty): swap, keeping allocated buffers
+	swap(buffer, flushBuffer);
+	swap(bufferedSize, flushBufferedSize);
+	pendingFlush = async(launch::async, &OutputStream::writeToFile, this, created, false);
+	created = true;
+}
+
+void OutputStream::waitFlush() {
+	if (pendingFlush.valid()) {
+		try {
+			// pass on any error from background write
+			pendingFlush.get();
+		} catch (...) {
+			errorMode = true;
+			throw;
 		}
 	}
+}
+
+void OutputStream::writeToFile(bool append, bool finish) {
+	ios_base::openmode openMode = std::ios_base::out;
+	if (binary || compressor.type != CompressionType::None) {
+		openMode |= std::ios_base::binary;
+	}
 	try {
-		open(filename, openMode);	// this can throw exception
-		if (is_open()) {
-			(*this) << buffer.str();
-			flush();
-			close();
-			clearBuffer();
-			created = true;
+		if (!file.is_open()) {
+			if (append) {
+				// append if already created
+				openMode |= std::ios_base::app;
+			} else {
+				// check/create path
+				filesystem::path path(filename);
+				filesystem::path parent = path.parent_path();
+				if (!filesystem::is_directory(parent)) {
+					filesystem::create_directories(parent);
+				}
+			}
+			file.open(filename, openMode);	// this can throw exception
+			if (!file.is_open()) {
+				throw ios_base::failure("Unable to write to file " + filename + "\n" + Util::getErr());
+			}
+		}
+		if (compressor.type != CompressionType::None) {
+			compressor.compress(flushBuffer, &compressBuffer, finish);
+			file << compressBuffer;
 		} else {
-			errorMode = true;
-			throw ios_base::failure("Unable to write to file " + filename + "\n" + Util::getErr());
+			file << flushBuffer;
 		}
+		flushBuffer.clear();
+		totalBuffered -= flushBufferedSize;
+		flushBufferedSize = 0;
 	} catch (ios_base::failure e) {
-		errorMode = true;
+		flushBuffer.clear();
+		totalBuffered -= flushBufferedSize;
+		flushBufferedSize = 0;
 		throw ios_base::failure("Unable to write to file " + filename + "\n" + Util::getErr());
 	}
 }
 
+void OutputStream::closeFile() {
+	if (file.is_open()) {
+		file.close();
+	}
+}
+
 void OutputStream::closeStream() {
 	if (!errorMode) {
-		write("");
+		waitFlush();
+		if (!buffer.empty() || compressor.started) {
+			swap(buffer, flushBuffer);
+			swap(bufferedSize, flushBufferedSize);
+			writeToFile(created, true);
+			created = true;
+		}
+		if (file.is_open()) {
+			// durability point: all output written to file
+			file.flush();
+			closeFile();
+		}
 	}
 }
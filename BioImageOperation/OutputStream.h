@@ -10,20 +10,37 @@
 #pragma once
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <string>
+#include <future>
+#include <atomic>
+#include <cstdint>
+#include "OutputCompressor.h"
 
 using namespace std;
 
 
 /*
- * Output stream helper
+ * Output stream helper; keeps file open and writes in background, formatting continues in second buffer (double buffered).
+ * Output is compressed (in background) for .gz / .zst file extension
  */
 
-class OutputStream : ofstream
+class OutputStream
 {
 public:
+	static atomic<size_t> totalBuffered;		// output in buffers of all streams, not yet written
+
 	string filename = "";
-	ostringstream buffer;
+	string buffer;
+	string flushBuffer;
+	string compressBuffer;
+	OutputCompressor compressor;
+	size_t bufferedSize = 0;
+	size_t flushBufferedSize = 0;
+	ofstream file;
+	future<void> pendingFlush;
+	uint64_t lastUse = 0;				// for pooled streams
+	bool rowStart = true;
+	bool binary = false;
 	bool created = false;
 	bool errorMode = false;
 
@@ -31,8 +48,38 @@ public:
 	~OutputStream();
 	void reset();
 	void clearBuffer();
-	void init(string filename, string header = "");
+	void init(string filename, string header = "", bool binary = false);
 	void write(string output);
-	void writeToFile();
+
+	/*
+	 * Row writer: values are formatted directly into buffer, separated by commas
+	 */
+	void addValue(int value);
+	void addValue(double value);
+	void addValue(bool value);
+	void addValue(const string& value);
+	void addEmpty(int n = 1);
+	void endRow();
+
+	/*
+	 * Start value (separator), to be composed by appending
+	 */
+	void startValue();
+	void appendNumber(int value);
+	void appendNumber(double value);
+	void appendChar(char c);
+
+	/*
+	 * Hand over buffer to background write, after previous background write finished
+	 */
+	void startFlush();
+	void waitFlush();
+	void writeToFile(bool append, bool finish = false);
+	void closeFile();
+	void updateBuffered();
+
+	/*
+	 * Write all remaining output and close file
+	 */
 	void closeStream();
 };
@@ -7,26 +7,102 @@
  * https://github.com/folterj/BioImageOperation
  *****************************************************************************/
 
+#include <vector>
+#include <algorithm>
 #include "OutputStreams.h"
+#include "Constants.h"
 
 
 OutputStreams::~OutputStreams() {
-	close();
+	try {
+		close();
+	} catch (exception& e) {
+		cerr << e.what() << endl;
+	}
 }
 
 void OutputStreams::close() {
+	exception_ptr error = nullptr;
+
 	for (auto item : *this) {
-		item.second->closeStream();
+		// close all streams; pass on first write error
+		try {
+			item.second->closeStream();
+		} catch (...) {
+			if (!error) {
+				error = current_exception();
+			}
+		}
+		delete item.second;
 	}
 	clear();
+	closedFilenames.clear();
+	useCount = 0;
+	if (error) {
+		rethrow_exception(error);
+	}
 }
 
 OutputStream* OutputStreams::get(string filename, string header) {
+	OutputStream* outputStream;
 	auto item = find(filename);
+
 	if (item != end()) {
-		return item->second;
+		outputStream = item->second;
+	} else {
+		if (size() >= Constants::maxOpenStreams) {
+			closeLeastRecent();
+		}
+		outputStream = new OutputStream();
+		if (closedFilenames.erase(filename) > 0) {
+			// continue existing file
+			outputStream->init(filename);
+			outputStream->created = true;
+		} else {
+			outputStream->init(filename, header);
+		}
+		emplace(filename, outputStream);
+	}
+	outputStream->lastUse = ++useCount;
+
+	if (OutputStream::totalBuffered > Constants::maxTotalBuffered) {
+		flushLeastRecent();
+	}
+	return outputStream;
+}
+
+void OutputStreams::closeLeastRecent() {
+	auto leastRecent = end();
+
+	for (auto item = begin(); item != end(); item++) {
+		if (leastRecent == end() || item->second->lastUse < leastRecent->second->lastUse) {
+			leastRecent = item;
+		}
+	}
+	if (leastRecent != end()) {
+		leastRecent->second->closeStream();
+		closedFilenames.insert(leastRecent->first);
+		delete leastRecent->second;
+		erase(leastRecent);
+	}
+}
+
+void OutputStreams::flushLeastRecent() {
+	vector<OutputStream*> streams;
+	size_t buffered = OutputStream::totalBuffered;
+
+	for (auto item : *this) {
+		if (!item.second->buffer.empty()) {
+			streams.push_back(item.second);
+		}
+	}
+	sort(streams.begin(), streams.end(), [](OutputStream* stream1, OutputStream* stream2) { return stream1->lastUse < stream2->lastUse; });
+
+	for (OutputStream* stream : streams) {
+		if (buffered <= Constants::maxTotalBuffered / 2) {
+			break;
+		}
+		buffered -= stream->buffer.size();
+		stream->startFlush();
 	}
-	OutputStream* newOutputStream = new OutputStream(filename, header);
-	emplace(filename, newOutputStream);
-	return newOutputStream;
 }
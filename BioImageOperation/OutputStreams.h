@@ -9,15 +9,29 @@
 
 #pragma once
 #include <map>
+#include <set>
 #include "OutputStream.h"
 
 using namespace std;
 
 
+/*
+ * Pool of output streams by filename; least recently used streams are closed to limit open files and buffered output
+ */
+
 class OutputStreams : map<string, OutputStream*>
 {
 public:
+	set<string> closedFilenames;		// closed to limit pool, appended when used again
+	uint64_t useCount = 0;
+
 	~OutputStreams();
 	void close();
 	OutputStream* get(string filename, string header = "");
+	void closeLeastRecent();
+
+	/*
+	 * Start writing least recently used streams, until total buffered output within limit
+	 */
+	void flushLeastRecent();
 };
@@ -0,0 +1,146 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+#include "PipeSource.h"
+#include "Constants.h"
+#include "Util.h"
+
+
+PipeSource::PipeSource() {
+}
+
+PipeSource::~PipeSource() {
+	close();
+}
+
+void PipeSource::reset() {
+	close();
+	source = "";
+	width = 0;
+	height = 0;
+	type = CV_8UC3;
+	frameSize = 0;
+	framei = 0;
+	interval = 1;
+	frameTime = -1;
+}
+
+bool PipeSource::init(string basepath, string filepath, int apiCode, string codecs, string start, string length,
+					  double fps, int interval, int total, int width, int height, int prefetch, int dropMode,
+					  bool cache, int colorMode, double timeout) {
+	reset();
+
+	if (width <= 0 || height <= 0) {
+		throw invalid_argument("Frame width and height required for pipe source");
+	}
+
+	this->source = filepath;
+	this->width = width;
+	this->height = height;
+
+	switch ((ImageColorMode)colorMode) {
+	case ImageColorMode::GrayScale: type = CV_8UC1; break;
+	case ImageColorMode::ColorAlpha: type = CV_8UC4; break;
+	default: type = CV_8UC3; break;
+	}
+	frameSize = (size_t)width * height * CV_ELEM_SIZE(type);
+
+	calcFrameParams(start, length, fps, interval, total, 0);
+
+	return open();
+}
+
+bool PipeSource::open() {
+	isStdin = (source == "" || source == "-");
+	if (isStdin) {
+		pipe = stdin;
+#ifdef _WIN32
+		_setmode(_fileno(stdin), _O_BINARY);
+#endif
+	} else {
+		pipe = fopen(source.c_str(), "rb");
+		if (!pipe) {
+			throw ios_base::failure("Unable to open pipe " + source);
+		}
+	}
+	openTime = chrono::steady_clock::now();
+	return true;
+}
+
+bool PipeSource::getNextImage(Mat* image) {
+	bool frameOk = false;
+
+	if (pipe && (end <= 0 || framei < end)) {
+		frameOk = readNextImage(image);
+	}
+	if (!frameOk) {
+		close();
+	}
+	return frameOk;
+}
+
+bool PipeSource::readNextImage(Mat* image) {
+	if (!image->isContinuous()) {
+		image->release();
+	}
+	do {
+		image->create(height, width, type);
+		if (fread(image->data, 1, frameSize, pipe) != frameSize) {
+			// end of stream (incomplete frame)
+			return false;
+		}
+		frameTime = chrono::duration<double>(chrono::steady_clock::now() - openTime).count();
+		framei++;
+	} while ((framei % interval) != 0);
+
+	return true;
+}
+
+void PipeSource::close() {
+	if (pipe && !isStdin) {
+		fclose(pipe);
+	}
+	pipe = nullptr;
+}
+
+int PipeSource::getWidth() {
+	return width;
+}
+
+int PipeSource::getHeight() {
+	return height;
+}
+
+double PipeSource::getFps() {
+	return fps;
+}
+
+int PipeSource::getFrameNumber() {
+	return framei;
+}
+
+string PipeSource::getLabel() {
+	return "";
+}
+
+int PipeSource::getCurrentFrame() {
+	return framei;
+}
+
+int PipeSource::getTotalFrames() {
+	return 0;
+}
+
+double PipeSource::getFrameTime() {
+	return frameTime;
+}
@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <cstdio>
+#include <chrono>
+#include <opencv2/opencv.hpp>
+#include "FrameSource.h"
+
+using namespace std;
+using namespace cv;
+
+
+/*
+ * Source for raw (uncompressed) frames of fixed size, read from standard input or (named) pipe
+ */
+
+class PipeSource : public FrameSource
+{
+public:
+	string source;
+	FILE* pipe = nullptr;
+	bool isStdin = false;
+	int width = 0;
+	int height = 0;
+	int type = CV_8UC3;
+	size_t frameSize = 0;
+	int framei = 0;
+	chrono::steady_clock::time_point openTime;
+	double frameTime = -1;
+
+	PipeSource();
+	~PipeSource();
+	void reset();
+	bool init(string basepath, string filepath, int apiCode, string codecs = "", string start = "", string length = "",
+			  double fps = 1, int interval = 1, int total = 0, int width = 0, int height = 0, int prefetch = 0, int dropMode = 0,
+			  bool cache = false, int colorMode = -1, double timeout = 0);
+	bool open();
+	bool getNextImage(Mat* image);
+
+	/*
+	 * Read frame directly into image buffer (reused if same size and type)
+	 */
+	bool readNextImage(Mat* image);
+	void close();
+
+	int getWidth();
+	int getHeight();
+	double getFps();
+	int getFrameNumber();
+
+	string getLabel();
+	int getCurrentFrame();
+	int getTotalFrames();
+	double getFrameTime();
+};
@@ -13,8 +13,11 @@
 #include "ScriptOperations.h"
 #include "Constants.h"
 #include "ImageSource.h"
+#include "StackSource.h"
 #include "VideoSource.h"
 #include "CaptureSource.h"
+#include "PipeSource.h"
+#include "SharedMemorySource.h"
 #include "ImageOutput.h"
 #include "VideoOutput.h"
 #include "Util.h"
@@ -24,9 +27,12 @@
 
 
 ScriptOperation::ScriptOperation() {
+	labelArguments.assign(ArgumentLabels.size(), nullptr);
 }
 
 ScriptOperation::~ScriptOperation() {
+	closePipeline(false);
+
 	if (innerOperations) {
 		delete innerOperations;
 	}
@@ -43,6 +49,8 @@ ScriptOperation::~ScriptOperation() {
 }
 
 void ScriptOperation::resetFrameSource() {
+	closePipeline(true);
+
 	if (frameSourceInit) {
 		frameSource->close();
 		delete frameSource;
@@ -50,6 +58,25 @@ void ScriptOperation::resetFrameSource() {
 	frameSourceInit = false;
 }
 
+void ScriptOperation::closePipeline(bool wait) {
+	FramePipeline* pipeline0 = pipeline;
+
+	pipeline = nullptr;
+	if (pipeline0) {
+		try {
+			if (wait) {
+				pipeline0->finish();
+			} else {
+				pipeline0->abort();
+			}
+		} catch (...) {
+			delete pipeline0;
+			throw;
+		}
+		delete pipeline0;
+	}
+}
+
 void ScriptOperation::reset() {
 	if (innerOperations) {
 		innerOperations->reset();
@@ -127,6 +154,7 @@ void ScriptOperation::extract(string original, string line) {
 	if (Util::contains(ScriptOperationTypes, operation)) {
 		operationType = (ScriptOperationType)Util::getListIndex(ScriptOperationTypes, operation);
 		parseArguments();
+		compileArguments();
 	} else {
 		throw invalid_argument("Unkown operation: " + operation);
 	}
@@ -202,6 +230,28 @@ void ScriptOperation::parseArguments() {
 	}
 }
 
+void ScriptOperation::compileArguments() {
+	labelArguments.assign(ArgumentLabels.size(), nullptr);
+	numericArgument = nullptr;
+	booleanArgument = nullptr;
+
+	for (Argument* argument : arguments) {
+		argument->compile();
+		if (!labelArguments[(int)argument->argumentLabel]) {
+			labelArguments[(int)argument->argumentLabel] = argument;
+		}
+		if (argument->isNumeric && !numericArgument) {
+			numericArgument = argument;
+		}
+		if (argument->isBoolean && !booleanArgument) {
+			booleanArgument = argument;
+		}
+	}
+	if (arguments.size() > 0) {
+		labelArguments[(int)ArgumentLabel::None] = arguments.at(0);
+	}
+}
+
 bool ScriptOperation::hasInnerOperations() {
 	if (innerOperations) {
 		return innerOperations->hasOperations();
@@ -218,38 +268,24 @@ ScriptOperation* ScriptOperation::getNextInnerOperation() {
 	return innerOperation;
 }
 
-string ScriptOperation::getArgument(ArgumentLabel label) {
-	string arg = "";
+const string& ScriptOperation::getArgument(ArgumentLabel label) {
+	static const string empty = "";
+	// label None: first argument
+	Argument* argument = labelArguments[(int)label];
 
-	if (label != ArgumentLabel::None) {
-		// search for label
-		for (Argument* argument : arguments) {
-			if (argument->argumentLabel == label) {
-				arg = argument->value;
-				break;
-			}
-		}
-	} else if (arguments.size() > 0) {
-		// else return first argument
-		arg = arguments.at(0)->value;
+	if (argument) {
+		return argument->value;
 	}
-	return arg;
+	return empty;
 }
 
 int ScriptOperation::getArgument(ArgumentLabel label, int defaultArgument) {
+	// label None: first argument
+	Argument* argument = labelArguments[(int)label];
 	int argumentValue = -1;
 
-	if (label != ArgumentLabel::None) {
-		// search for label
-		for (Argument* argument : arguments) {
-			if (argument->argumentLabel == label) {
-				argumentValue = argument->valueEnum;
-				break;
-			}
-		}
-	} else if (arguments.size() > 0) {
-		// else return first argument
-		argumentValue = arguments.at(0)->valueEnum;
+	if (argument) {
+		argumentValue = argument->valueEnum;
 	}
 	if (argumentValue < 0) {
 		argumentValue = defaultArgument;
@@ -258,21 +294,20 @@ int ScriptOperation::getArgument(ArgumentLabel label, int defaultArgument) {
 }
 
 double ScriptOperation::getArgumentNumeric(ArgumentLabel label, bool oneBase) {
+	Argument* argument;
 	double x = 0;
-	string arg;
 
 	if (label != ArgumentLabel::None) {
-		// search for label
-		arg = getArgument(label);
-		x = Util::toDouble(arg);
+		argument = labelArguments[(int)label];
 	} else {
 		// find numeric argument
-		for (int argumenti = 0; argumenti < arguments.size(); argumenti++) {
-			arg = arguments.at(argumenti)->value;
-			if (Util::isNumeric(arg)) {
-				x = Util::toDouble(arg);
-				break;
-			}
+		argument = numericArgument;
+	}
+	if (argument) {
+		if (argument->isNumeric) {
+			x = argument->valueNumeric;
+		} else {
+			x = Util::toDouble(argument->value);	// throws for invalid value
 		}
 	}
 
@@ -285,30 +320,18 @@ double ScriptOperation::getArgumentNumeric(ArgumentLabel label, bool oneBase) {
 }
 
 bool ScriptOperation::getArgumentBoolean(ArgumentLabel label) {
+	Argument* argument;
 	bool b = false;
-	string arg;
 
 	if (label != ArgumentLabel::None) {
-		// search for label
-		for (Argument* argument : arguments) {
-			if (argument->argumentLabel == label) {
-				arg = argument->value;
-				b = true;
-				if (Util::isBoolean(arg)) {
-					b = Util::toBoolean(arg);
-				}
-				break;
-			}
+		argument = labelArguments[(int)label];
+		if (argument) {
+			// no value: true
+			b = (!argument->isBoolean || argument->valueBoolean);
 		}
-	} else {
+	} else if (booleanArgument) {
 		// find boolean argument
-		for (int argumenti = 0; argumenti < arguments.size(); argumenti++) {
-			arg = arguments.at(argumenti)->value;
-			if (Util::isBoolean(arg)) {
-				b = Util::toBoolean(arg);
-				break;
-			}
-		}
+		b = booleanArgument->valueBoolean;
 	}
 	return b;
 }
@@ -339,38 +362,56 @@ OperationInfo ScriptOperation::getOperationInfo(ScriptOperationType type) {
 
 	case ScriptOperationType::OpenImage:
 		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Path };
-		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Start, ArgumentLabel::Length, ArgumentLabel::Interval, ArgumentLabel::Total };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Start, ArgumentLabel::Length, ArgumentLabel::Interval, ArgumentLabel::Total, ArgumentLabel::Prefetch, ArgumentLabel::Stages, ArgumentLabel::Branches, ArgumentLabel::Timeout };
 		description = "Open image file(s) for processing, accepts file name pattern";
 		break;
 
+	case ScriptOperationType::OpenStack:
+		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Path };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Start, ArgumentLabel::Length, ArgumentLabel::Interval, ArgumentLabel::Total, ArgumentLabel::Prefetch, ArgumentLabel::Stages, ArgumentLabel::Branches };
+		description = "Open multi-page image (TIFF) stack file(s) and process pages, accepts file name pattern";
+		break;
+
 	case ScriptOperationType::OpenVideo:
 		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Path };
-		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::API, ArgumentLabel::Start, ArgumentLabel::Length, ArgumentLabel::Interval, ArgumentLabel::Total };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::API, ArgumentLabel::Start, ArgumentLabel::Length, ArgumentLabel::Interval, ArgumentLabel::Total, ArgumentLabel::Prefetch, ArgumentLabel::Workers, ArgumentLabel::Stages, ArgumentLabel::Branches, ArgumentLabel::Cache, ArgumentLabel::ColorMode };
 		description = "Open video file(s) and process frames, accepts file name pattern (ffmpeg formats supported)";
 		break;
 
 	case ScriptOperationType::OpenCapture:
 		// * TODO: add option to set width/height
 		requiredArguments = vector<ArgumentLabel> { };
-		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Path, ArgumentLabel::Source, ArgumentLabel::API, ArgumentLabel::Codec, ArgumentLabel::Fps, ArgumentLabel::Length, ArgumentLabel::Interval, ArgumentLabel::Total, ArgumentLabel::Width, ArgumentLabel::Height };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Path, ArgumentLabel::Source, ArgumentLabel::API, ArgumentLabel::Codec, ArgumentLabel::Fps, ArgumentLabel::Length, ArgumentLabel::Interval, ArgumentLabel::Total, ArgumentLabel::Width, ArgumentLabel::Height, ArgumentLabel::Prefetch, ArgumentLabel::DropMode, ArgumentLabel::Stages, ArgumentLabel::Branches };
 		description = "Open capturing from video (IP) path or camera source";
 		break;
 
+	case ScriptOperationType::OpenPipe:
+		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Width, ArgumentLabel::Height };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Path, ArgumentLabel::ColorMode, ArgumentLabel::Fps, ArgumentLabel::Length, ArgumentLabel::Interval, ArgumentLabel::Total, ArgumentLabel::Stages, ArgumentLabel::Branches };
+		description = "Open raw frames from standard input or (named) pipe path";
+		break;
+
+	case ScriptOperationType::OpenSharedMemory:
+		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Path };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Length, ArgumentLabel::Timeout, ArgumentLabel::Stages, ArgumentLabel::Branches };
+		description = "Open frames from shared memory ring buffer of acquisition process (shared memory name)";
+		break;
+
 	case ScriptOperationType::Source:
 		requiredArguments = vector<ArgumentLabel>{ ArgumentLabel::Path };
-		optionalArguments = vector<ArgumentLabel>{ };
+		optionalArguments = vector<ArgumentLabel>{ ArgumentLabel::Workers };
 		description = "Open sources for individual processing";
 		break;
 
 	case ScriptOperationType::SaveImage:
 		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Path };
-		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Label, ArgumentLabel::Start, ArgumentLabel::Length };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Label, ArgumentLabel::Start, ArgumentLabel::Length, ArgumentLabel::Queue };
 		description = "Save image to file";
 		break;
 
 	case ScriptOperationType::SaveVideo:
 		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Path };
-		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Label, ArgumentLabel::Start, ArgumentLabel::Length, ArgumentLabel::Fps, ArgumentLabel::Codec };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Label, ArgumentLabel::Start, ArgumentLabel::Length, ArgumentLabel::Fps, ArgumentLabel::Codec, ArgumentLabel::Queue };
 		description = "Create video file and save image to video file (supports installed encoders)";
 		break;
 
@@ -641,13 +682,13 @@ OperationInfo ScriptOperation::getOperationInfo(ScriptOperationType type) {
 
 	case ScriptOperationType::SaveClusters:
 		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Path };
-		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Tracker, ArgumentLabel::Format, ArgumentLabel::Contour };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Tracker, ArgumentLabel::Format, ArgumentLabel::Contour, ArgumentLabel::ContourFormat };
 		description = "Save clusters to CSV file";
 		break;
 
 	case ScriptOperationType::SaveTracks:
 		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Path };
-		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Tracker, ArgumentLabel::Format, ArgumentLabel::Contour };
+		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Tracker, ArgumentLabel::Format, ArgumentLabel::Contour, ArgumentLabel::ContourFormat };
 		description = "Save cluster tracking to CSV file";
 		break;
 
@@ -669,6 +710,12 @@ OperationInfo ScriptOperation::getOperationInfo(ScriptOperationType type) {
 		description = "Save tracking information to CSV file";
 		break;
 
+	case ScriptOperationType::SaveCaptureInfo:
+		requiredArguments = vector<ArgumentLabel> { ArgumentLabel::Path };
+		optionalArguments = vector<ArgumentLabel> { };
+		description = "Save capture frame time and dropped frames to CSV file";
+		break;
+
 	case ScriptOperationType::DrawLegend:
 		requiredArguments = vector<ArgumentLabel> { };
 		optionalArguments = vector<ArgumentLabel> { ArgumentLabel::Label, ArgumentLabel::Display, ArgumentLabel::Position };
@@ -720,6 +767,7 @@ ArgumentType ScriptOperation::getExpectedArgumentType(ArgumentLabel argument) {
 
 	case ArgumentLabel::Contour:
 	case ArgumentLabel::Debug:
+	case ArgumentLabel::Cache:
 		type = ArgumentType::Bool;
 		break;
 
@@ -748,11 +796,17 @@ ArgumentType ScriptOperation::getExpectedArgumentType(ArgumentLabel argument) {
 	case ArgumentLabel::NY:
 	case ArgumentLabel::Interval:
 	case ArgumentLabel::Total:
+	case ArgumentLabel::Prefetch:
+	case ArgumentLabel::Queue:
+	case ArgumentLabel::Workers:
+	case ArgumentLabel::Stages:
+	case ArgumentLabel::Branches:
 	case ArgumentLabel::MS:
 	case ArgumentLabel::Power:
 	case ArgumentLabel::Source:
 	case ArgumentLabel::API:
 	case ArgumentLabel::Fps:
+	case ArgumentLabel::Timeout:
 	case ArgumentLabel::Factor:
 	case ArgumentLabel::Maximum:
 	case ArgumentLabel::MinArea:
@@ -808,6 +862,14 @@ ArgumentType ScriptOperation::getExpectedArgumentType(ArgumentLabel argument) {
 		type = ArgumentType::Position;
 		break;
 
+	case ArgumentLabel::DropMode:
+		type = ArgumentType::DropMode;
+		break;
+
+	case ArgumentLabel::ContourFormat:
+		type = ArgumentType::ContourFormat;
+		break;
+
 		// end of switch
 	}
 	return type;
@@ -908,6 +970,26 @@ string ScriptOperation::getArgumentDescription(ArgumentLabel argument) {
 		s = "Total number of frames at regular interval";
 		break;
 
+	case ArgumentLabel::Prefetch:
+		s = "Number of frames to decode ahead in background (0: disabled)";
+		break;
+
+	case ArgumentLabel::Queue:
+		s = "Number of frames to queue for writing in background (0: disabled)";
+		break;
+
+	case ArgumentLabel::Workers:
+		s = "Number of parallel workers (0: disabled)";
+		break;
+
+	case ArgumentLabel::Stages:
+		s = "Number of pipeline stages processing the operations block concurrently (0: disabled)";
+		break;
+
+	case ArgumentLabel::Branches:
+		s = "Number of independent operations processed concurrently per stage (0: disabled)";
+		break;
+
 	case ArgumentLabel::MS:
 		s = "Time in milliseconds";
 		break;
@@ -1016,10 +1098,26 @@ string ScriptOperation::getArgumentDescription(ArgumentLabel argument) {
 		s = "Draw position";
 		break;
 
+	case ArgumentLabel::DropMode:
+		s = "Frame drop mode when processing is slower than capture";
+		break;
+
+	case ArgumentLabel::Cache:
+		s = "Cache decoded frames on disk for faster repeated processing";
+		break;
+
+	case ArgumentLabel::Timeout:
+		s = "Stop waiting for new frames after timeout [s] (0: disabled)";
+		break;
+
 	case ArgumentLabel::Contour:
 		s = "Extract contours";
 		break;
 
+	case ArgumentLabel::ContourFormat:
+		s = "Contour format: points (x y ...) or start point followed by Freeman chain code";
+		break;
+
 	case ArgumentLabel::Debug:
 		s = "Debug mode";
 		break;
@@ -1105,6 +1203,14 @@ string ScriptOperation::getArgumentTypeDescription(ArgumentType type) {
 		s = Util::getValueList(DrawPositions);
 		break;
 
+	case ArgumentType::DropMode:
+		s = Util::getValueList(DropModes);
+		break;
+
+	case ArgumentType::ContourFormat:
+		s = Util::getValueList(ContourFormats);
+		break;
+
 		// end of switch
 	}
 	return s;
@@ -1230,17 +1336,21 @@ string ScriptOperation::getOperationListSimple() {
 }
 
 bool ScriptOperation::initFrameSource(FrameType frameType, string basepath, string templatePath, int apiCode, string codecs, string start, string length,
-									  double fps0, int interval, int total, int width, int height) {
+									  double fps0, int interval, int total, int width, int height, int prefetch, int dropMode,
+									  bool cache, int colorMode, double timeout) {
 	bool ok = true;
 
 	if (!frameSourceInit) {
 		switch (frameType) {
 		case FrameType::Image: frameSource = new ImageSource(); break;
+		case FrameType::Stack: frameSource = new StackSource(); break;
 		case FrameType::Video: frameSource = new VideoSource(); break;
 		case FrameType::Capture: frameSource = new CaptureSource(); break;
+		case FrameType::Pipe: frameSource = new PipeSource(); break;
+		case FrameType::SharedMemory: frameSource = new SharedMemorySource(); break;
 		}
 		if (frameSource) {
-			ok = frameSource->init(basepath, templatePath, apiCode, codecs, start, length, fps0, interval, total, width, height);
+			ok = frameSource->init(basepath, templatePath, apiCode, codecs, start, length, fps0, interval, total, width, height, prefetch, dropMode, cache, colorMode, timeout);
 			frameSourceInit = true;
 		}
 	}
@@ -1248,14 +1358,14 @@ bool ScriptOperation::initFrameSource(FrameType frameType, string basepath, stri
 }
 
 void ScriptOperation::initFrameOutput(FrameType frameType, string basepath, string templatePath, string defaultExtension, string start, string length,
-									  double fps, string codecs) {
+									  double fps, string codecs, int queue) {
 	if (!frameOutputInit) {
 		switch (frameType) {
 		case FrameType::Image: frameOutput = new ImageOutput(); break;
 		case FrameType::Video: frameOutput = new VideoOutput(); break;
 		}
 		if (frameOutput) {
-			frameOutput->init(basepath, templatePath, defaultExtension, start, length, fps, codecs);
+			frameOutput->init(basepath, templatePath, defaultExtension, start, length, fps, codecs, queue);
 			frameOutputInit = true;
 		}
 	}
@@ -1302,6 +1412,8 @@ void ScriptOperation::updateBenchmarking() {
 }
 
 void ScriptOperation::close() {
+	closePipeline(false);
+
 	if (innerOperations) {
 		innerOperations->close();
 	}
@@ -1314,3 +1426,16 @@ void ScriptOperation::close() {
 		frameOutput->close();
 	}
 }
+
+string ScriptOperation::getOutputStatistics() {
+	string s;
+
+	if (innerOperations) {
+		s += innerOperations->getOutputStatistics();
+	}
+
+	if (frameOutputInit) {
+		s += frameOutput->getStatistics();
+	}
+	return s;
+}
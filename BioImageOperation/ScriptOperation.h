@@ -15,6 +15,7 @@
 #include "OperationInfo.h"
 #include "FrameSource.h"
 #include "FrameOutput.h"
+#include "FramePipeline.h"
 #include "Types.h"
 
 using namespace cv;
@@ -28,10 +29,15 @@ class ScriptOperation
 public:
 	ScriptOperationType operationType = ScriptOperationType::None;
 	vector<Argument*> arguments;
+	vector<Argument*> labelArguments;		// compiled: first argument per label (None: first argument)
+	Argument* numericArgument = nullptr;	// compiled: first numeric argument
+	Argument* booleanArgument = nullptr;	// compiled: first boolean argument
 	int argumentPos = 0;
 	bool positionalMode = false;
 	string original, line;
 	string asignee;
+	int imageSlot = -1;		// resolved Label argument
+	int asigneeSlot = -1;	// resolved asignee
 	string extra;
 	int lineStart = 0;
 	int lineEnd = 0;
@@ -45,6 +51,7 @@ public:
 	bool frameOutputInit = false;
 	FrameSource* frameSource = nullptr;
 	FrameOutput* frameOutput = nullptr;
+	FramePipeline* pipeline = nullptr;
 	Mat image;
 	Mat* imageRef = nullptr;
 	Clock::time_point start;
@@ -56,14 +63,24 @@ public:
 	ScriptOperation();
 	~ScriptOperation();
 	void resetFrameSource();
+
+	/*
+	 * Stop pipeline processing inner operations; wait for frames in flight, or else discard them
+	 */
+	void closePipeline(bool wait);
 	void reset();
 	void initialFinish();
 	void finish();
 	void extract(string original, string line);
 	void parseArguments();
+
+	/*
+	 * Resolve arguments once after parsing, so per frame argument queries are direct lookups
+	 */
+	void compileArguments();
 	bool hasInnerOperations();
 	ScriptOperation* getNextInnerOperation();
-	string getArgument(ArgumentLabel label = ArgumentLabel::None);
+	const string& getArgument(ArgumentLabel label = ArgumentLabel::None);
 	int getArgument(ArgumentLabel label, int defaultArgument);
 	double getArgumentNumeric(ArgumentLabel label = ArgumentLabel::None, bool oneBase = false);
 	bool getArgumentBoolean(ArgumentLabel label = ArgumentLabel::None);
@@ -77,13 +94,15 @@ public:
 	static string getOperationListSimple();
 
 	bool initFrameSource(FrameType frameType, string basepath, string templatePath, int apiCode, string codecs = "", string start = "", string length = "",
-						 double fps0 = 1, int interval = 1, int total = 0, int width=0, int height=0);
+						 double fps0 = 1, int interval = 1, int total = 0, int width=0, int height=0, int prefetch = 0, int dropMode = 0,
+						 bool cache = false, int colorMode = -1, double timeout = 0);
 	void initFrameOutput(FrameType frameType, string basepath, string templatePath, string defaultExtension = "", string start = "", string length = "",
-						 double fps = 0, string codecs = "");
+						 double fps = 0, string codecs = "", int queue = 0);
 	double getDuration();
 	double getDurationInit();
 	void updateBenchmarking();
 	void close();
+	string getOutputStatistics();
 
 private:
 	void resetNextArgument();
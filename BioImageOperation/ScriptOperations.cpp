@@ -9,6 +9,7 @@
 
 #include "ScriptOperations.h"
 #include "ScriptOperation.h"
+#include "ImageItemList.h"
 #include "Util.h"
 
 
@@ -65,6 +66,10 @@ void ScriptOperations::extract(string script) {
 	createOperationLineList(this);
 }
 
+string ScriptOperations::getScript() {
+	return script;
+}
+
 int ScriptOperations::extract(vector<string> lines, int startlinei, int startIndentLevel, bool useIndent) {
 	ScriptOperation* operation = nullptr;
 	string original, line;
@@ -130,10 +135,31 @@ void ScriptOperations::createOperationLineList(ScriptOperations* operations) {
 	}
 }
 
+void ScriptOperations::assignImageSlots(ImageItemList* imageList) {
+	string label;
+
+	for (ScriptOperation* operation : *this) {
+		label = operation->getArgument(ArgumentLabel::Label);
+		if (label != "") {
+			operation->imageSlot = imageList->getSlot(label, operation->operationType == ScriptOperationType::StoreImage);
+		}
+		if (operation->asignee != "") {
+			operation->asigneeSlot = imageList->getSlot(operation->asignee, true);
+		}
+		if (operation->innerOperations) {
+			operation->innerOperations->assignImageSlots(imageList);
+		}
+	}
+}
+
 bool ScriptOperations::hasOperations() {
 	return (size() > 0);
 }
 
+vector<ScriptOperation*> ScriptOperations::getOperations() {
+	return vector<ScriptOperation*>(begin(), end());
+}
+
 ScriptOperation* ScriptOperations::getCurrentOperation() {
 	ScriptOperation* operation = nullptr;
 	if (currentOperationi < size()) {
@@ -142,6 +168,16 @@ ScriptOperation* ScriptOperations::getCurrentOperation() {
 	return operation;
 }
 
+bool ScriptOperations::setCurrentOperation(ScriptOperation* operation) {
+	for (int operationi = 0; operationi < size(); operationi++) {
+		if (at(operationi) == operation) {
+			currentOperationi = operationi;
+			return true;
+		}
+	}
+	return false;
+}
+
 ScriptOperation* ScriptOperations::getOperation(int linei) {
 	auto item = operationLineMap.find(linei);
 	if (item != operationLineMap.end()) {
@@ -194,3 +230,11 @@ void ScriptOperations::close() {
 		at(i)->close();
 	}
 }
+
+string ScriptOperations::getOutputStatistics() {
+	string s;
+	for (int i = 0; i < size(); i++) {
+		s += at(i)->getOutputStatistics();
+	}
+	return s;
+}
@@ -16,6 +16,7 @@ using namespace std;
 
 
 class ScriptOperation;	// forward declaration
+class ImageItemList;	// forward declaration
 
 
 /*
@@ -34,14 +35,27 @@ public:
 	~ScriptOperations();
 	void reset();
 	void extract(string script);
+	string getScript();
 	int extract(vector<string> lines, int startlinei, int startIndentLevel, bool useIndent);
 	void createOperationLineList(ScriptOperations* operations);
+
+	/*
+	 * Resolve image labels of all (inner) operations to image list slots
+	 */
+	void assignImageSlots(ImageItemList* imageList);
 	bool hasOperations();
+	vector<ScriptOperation*> getOperations();
 	ScriptOperation* getCurrentOperation();
+
+	/*
+	 * Continue processing at (root) operation
+	 */
+	bool setCurrentOperation(ScriptOperation* operation);
 	ScriptOperation* getOperation(int linei);
 	bool moveNextOperation();
 	void updateBenchmarking();
 	string renderOperations();
 	void renderOperations(vector<string>* lines);
 	void close();
+	string getOutputStatistics();
 };
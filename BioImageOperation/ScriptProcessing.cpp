@@ -8,15 +8,33 @@
  *****************************************************************************/
 
 #include <filesystem>
+#include <algorithm>
 #include "KeepAlive.h"
 #include "ScriptProcessing.h"
 #include "ImageOperations.h"
 #include "NumericPath.h"
 #include "TextObserver.h"
+#include "TrackStitcher.h"
+#include "FrameCache.h"
+#include "SharedMemorySource.h"
 #include "Constants.h"
 #include "Util.h"
 
 
+thread_local int ScriptProcessing::sourceFrameNumber = 0;
+thread_local double ScriptProcessing::sourceFrameTime = -1;
+thread_local int ScriptProcessing::sourceDroppedFrames = 0;
+thread_local ImageItemList* ScriptProcessing::stageImageList = nullptr;
+
+
+PipelineStage::~PipelineStage() {
+	if (graph) {
+		delete graph;
+		graph = nullptr;
+	}
+}
+
+
 ScriptProcessing::ScriptProcessing() {
 	// initialise static lookup tables
 	ColorScale::init();
@@ -74,6 +92,8 @@ void ScriptProcessing::reset() {
 	sourceFps = 0;
 	sourceFrames = 0;
 	sourceFrameNumber = 0;
+	sourceFrameTime = -1;
+	sourceDroppedFrames = 0;
 	pixelSize = 1;
 	windowSize = 1;
 	logPower = 0;
@@ -114,7 +134,7 @@ bool ScriptProcessing::startProcessNoGui(string scriptFilename) {
 
 	try {
 		script = Util::readText(scriptFilename);
-		scriptOperations->extract(script);
+		extractScript(script);
 		this->observer->resetProgressTimer();
 		operationMode = OperationMode::Run;
 		processThreadMethod();
@@ -132,7 +152,7 @@ bool ScriptProcessing::startProcess(string filepath, string script) {
 			if (operationMode == OperationMode::Idle) {
                 reset();
                 basepath = Util::extractFilePath(filepath);
-				scriptOperations->extract(script);
+				extractScript(script);
 			}
 			observer->resetProgressTimer();
 			operationMode = OperationMode::Run;
@@ -162,6 +182,12 @@ void ScriptProcessing::processThreadMethod() {
 	}
 }
 
+void ScriptProcessing::processWorkerMethod() {
+	processOperations(scriptOperations, nullptr);
+	imageTrackers->close();
+	scriptOperations->close();
+}
+
 void ScriptProcessing::processOperations(ScriptOperations* operations, ScriptOperation* prevOperation0) {
 	bool isRoot = (prevOperation0 == nullptr);
 	ScriptOperation* operation;
@@ -178,6 +204,10 @@ void ScriptProcessing::processOperations(ScriptOperations* operations, ScriptOpe
 			operationFinished = processOperation(operation, prevOperation);
 			operation->finish();
 			if (operationFinished) {
+				if (isRoot && operation->lineStart == workerLine) {
+					// worker task complete
+					operationMode = OperationMode::Idle;
+				}
 				operations->moveNextOperation();
 			}
 			if (operationMode == OperationMode::RequestPause && (isRoot || operation->hasInnerOperations())) {
@@ -220,16 +250,18 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 
 	NumericPath sourcePath, outputPath;
 	ImageTracker* imageTracker;
-	string path, source, output, label;
-	int width, height;
+	string path, source, output, label, start, length;
+	int width, height, interval, total;
 	int displayi;
-	double fps, size, thresh0, thresh;
+	double fps, size, thresh0, thresh, timeout;
 	double hmin, hmax, smin, smax, vmin, vmax;
 	int frame = sourceFrameNumber;
 
 	int delay;
 	bool debugMode;
+	SaveFormat saveFormat;
 	bool done = true;
+	bool resetSource = false;	// close frame source after inner operations processed last image
 
 	try {
 		switch (operation->operationType) {
@@ -265,6 +297,14 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			break;
 
 		case ScriptOperationType::Source:
+			if (workerLine < 0 && operation->getArgumentNumeric(ArgumentLabel::Workers) > 1) {
+				processSources(operation, (int)operation->getArgumentNumeric(ArgumentLabel::Workers));
+				return true;
+			}
+			if (operation->lineStart == workerLine && sourceFilei > workerSourcei) {
+				// worker: only assigned file
+				return true;
+			}
 			imageTrackers->reset();
 			observer->resetProgressTimer();
 			sourcePath.setInputPath(basepath, operation->getArgument(ArgumentLabel::Path));
@@ -295,6 +335,9 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			sourceWidth = width;
 			sourceHeight = height;
 			sourceFrameNumber = 0;
+			// no capture time: time from frame number
+			sourceFrameTime = -1;
+			sourceDroppedFrames = 0;
 			newImageSet = true;
 			break;
 
@@ -304,14 +347,29 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			} else {
 				source = operation->getArgument(ArgumentLabel::Path);
 			}
+			timeout = operation->getArgumentNumeric(ArgumentLabel::Timeout);
 			operation->initFrameSource(FrameType::Image, basepath, source, 0, "",
 										operation->getArgument(ArgumentLabel::Start),
 										operation->getArgument(ArgumentLabel::Length),
 										sourceFps,
 										(int)operation->getArgumentNumeric(ArgumentLabel::Interval),
-										(int)operation->getArgumentNumeric(ArgumentLabel::Total));
+										(int)operation->getArgumentNumeric(ArgumentLabel::Total), 0, 0,
+										(int)operation->getArgumentNumeric(ArgumentLabel::Prefetch), 0,
+										false, -1, timeout);
 			sourceFrameNumber = operation->frameSource->getFrameNumber();
-			if (operation->frameSource->getNextImage(newImage)) {
+			sourceFrameTime = -1;
+			sourceDroppedFrames = 0;
+			if (timeout > 0) {
+				// streaming: wait for next new file
+				if (!operation->frameSource->getNextImage(newImage)) {
+					// no new file before timeout; current image invalid
+					operation->resetFrameSource();
+					return true;
+				}
+				sourceFrames = operation->frameSource->getTotalFrames();
+				showStatus(operation->frameSource->getCurrentFrame(), sourceFrames, operation->frameSource->getLabel());
+				done = false;
+			} else if (operation->frameSource->getNextImage(newImage)) {
 				sourceFrames = operation->frameSource->getTotalFrames();
 				if (sourceFrames > 1) {
 					showStatus(operation->frameSource->getCurrentFrame(), sourceFrames);
@@ -321,9 +379,39 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			sourceWidth = operation->frameSource->getWidth();
 			sourceHeight = operation->frameSource->getHeight();
 			newImageSet = true;
-			if (done) {
+			// last image still valid: push to pipeline before closing it
+			resetSource = done;
+			break;
+
+		case ScriptOperationType::OpenStack:
+			if (sourceFile != "") {
+				source = sourceFile;
+			} else {
+				source = operation->getArgument(ArgumentLabel::Path);
+			}
+			operation->initFrameSource(FrameType::Stack, basepath, source, 0, "",
+										operation->getArgument(ArgumentLabel::Start),
+										operation->getArgument(ArgumentLabel::Length),
+										sourceFps,
+										(int)operation->getArgumentNumeric(ArgumentLabel::Interval),
+										(int)operation->getArgumentNumeric(ArgumentLabel::Total), 0, 0,
+										(int)operation->getArgumentNumeric(ArgumentLabel::Prefetch));
+			sourceFrameNumber = operation->frameSource->getFrameNumber();
+			sourceFrameTime = -1;
+			sourceDroppedFrames = 0;
+			if (operation->frameSource->getNextImage(newImage)) {
+				label = getSourceLabel() + operation->frameSource->getLabel();
+				showStatus(operation->frameSource->getCurrentFrame(), operation->frameSource->getTotalFrames(), label);
+				done = false;
+			} else {
+				// already past last page; current image invalid
 				operation->resetFrameSource();
+				return true;
 			}
+			sourceWidth = operation->frameSource->getWidth();
+			sourceHeight = operation->frameSource->getHeight();
+			sourceFrames = operation->frameSource->getTotalFrames();
+			newImageSet = true;
 			break;
 
         case ScriptOperationType::OpenVideo:
@@ -332,13 +420,30 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			} else {
 				source = operation->getArgument(ArgumentLabel::Path);
 			}
+			if (workerLine < 0 && operation->getArgumentNumeric(ArgumentLabel::Workers) > 1) {
+				processSegments(operation, source, (int)operation->getArgumentNumeric(ArgumentLabel::Workers));
+				return true;
+			}
+			start = operation->getArgument(ArgumentLabel::Start);
+			length = operation->getArgument(ArgumentLabel::Length);
+			interval = (int)operation->getArgumentNumeric(ArgumentLabel::Interval);
+			total = (int)operation->getArgumentNumeric(ArgumentLabel::Total);
+			if (segmenti >= 0 && operation->lineStart == workerLine) {
+				// worker: assigned segment only
+				start = to_string(segmentStart);
+				length = to_string(segmentEnd - segmentStart);
+				interval = segmentInterval;
+				total = 0;
+			}
 			operation->initFrameSource(FrameType::Video, basepath, source,
 										(int)operation->getArgumentNumeric(ArgumentLabel::API), operation->getArgument(ArgumentLabel::Codec),
-										operation->getArgument(ArgumentLabel::Start),
-										operation->getArgument(ArgumentLabel::Length), 0,
-										(int)operation->getArgumentNumeric(ArgumentLabel::Interval),
-										(int)operation->getArgumentNumeric(ArgumentLabel::Total));
+										start, length, 0, interval, total, 0, 0,
+										(int)operation->getArgumentNumeric(ArgumentLabel::Prefetch), 0,
+										operation->getArgumentBoolean(ArgumentLabel::Cache),
+										operation->getArgument(ArgumentLabel::ColorMode, -1));
 			sourceFrameNumber = operation->frameSource->getFrameNumber();
+			sourceFrameTime = -1;
+			sourceDroppedFrames = 0;
 			if (operation->frameSource->getNextImage(newImage)) {
 				label = getSourceLabel() + operation->frameSource->getLabel();
 				showStatus(operation->frameSource->getCurrentFrame(), operation->frameSource->getTotalFrames(), label);
@@ -367,10 +472,18 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 										(int)operation->getArgumentNumeric(ArgumentLabel::Interval),
 										(int)operation->getArgumentNumeric(ArgumentLabel::Total),
 										(int)operation->getArgumentNumeric(ArgumentLabel::Width),
-										(int)operation->getArgumentNumeric(ArgumentLabel::Height));
+										(int)operation->getArgumentNumeric(ArgumentLabel::Height),
+										(int)operation->getArgumentNumeric(ArgumentLabel::Prefetch),
+										operation->getArgument(ArgumentLabel::DropMode, (int)DropMode::DropOldest));
 			sourceFrameNumber = operation->frameSource->getFrameNumber();
 			if (operation->frameSource->getNextImage(newImage)) {
-				showStatus(operation->frameSource->getCurrentFrame());
+				sourceFrameTime = operation->frameSource->getFrameTime();
+				sourceDroppedFrames = operation->frameSource->getDroppedFrames();
+				label = "";
+				if (sourceDroppedFrames > 0) {
+					label = "Dropped: " + to_string(sourceDroppedFrames);
+				}
+				showStatus(operation->frameSource->getCurrentFrame(), 0, label);
 				done = false;
 			} else {
 				// capture failed; current image invalid
@@ -383,11 +496,63 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			newImageSet = true;
 			break;
 
+		case ScriptOperationType::OpenPipe:
+			operation->initFrameSource(FrameType::Pipe, basepath, operation->getArgument(ArgumentLabel::Path), 0, "",
+										"", operation->getArgument(ArgumentLabel::Length),
+										operation->getArgumentNumeric(ArgumentLabel::Fps),
+										(int)operation->getArgumentNumeric(ArgumentLabel::Interval),
+										(int)operation->getArgumentNumeric(ArgumentLabel::Total),
+										(int)operation->getArgumentNumeric(ArgumentLabel::Width),
+										(int)operation->getArgumentNumeric(ArgumentLabel::Height), 0, 0,
+										false, operation->getArgument(ArgumentLabel::ColorMode, (int)ImageColorMode::Color));
+			sourceFrameNumber = operation->frameSource->getFrameNumber();
+			if (operation->frameSource->getNextImage(newImage)) {
+				sourceFrameTime = operation->frameSource->getFrameTime();
+				sourceDroppedFrames = 0;
+				showStatus(operation->frameSource->getCurrentFrame());
+				done = false;
+			} else {
+				// end of stream; current image invalid
+				operation->resetFrameSource();
+				return true;
+			}
+			sourceWidth = operation->frameSource->getWidth();
+			sourceHeight = operation->frameSource->getHeight();
+			sourceFrames = 0;
+			newImageSet = true;
+			break;
+
+		case ScriptOperationType::OpenSharedMemory:
+			operation->initFrameSource(FrameType::SharedMemory, basepath, operation->getArgument(ArgumentLabel::Path), 0, "",
+										"", operation->getArgument(ArgumentLabel::Length), 0, 1, 0, 0, 0, 0, 0,
+										false, -1, operation->getArgumentNumeric(ArgumentLabel::Timeout));
+			sourceFrameNumber = operation->frameSource->getFrameNumber();
+			if (operation->frameSource->getNextImage(newImage)) {
+				sourceFrameTime = operation->frameSource->getFrameTime();
+				sourceDroppedFrames = operation->frameSource->getDroppedFrames();
+				label = "";
+				if (sourceDroppedFrames > 0) {
+					label = "Overruns: " + to_string(sourceDroppedFrames);
+				}
+				showStatus(operation->frameSource->getCurrentFrame(), 0, label);
+				done = false;
+			} else {
+				// no new frame before timeout; current image invalid
+				operation->resetFrameSource();
+				return true;
+			}
+			sourceWidth = operation->frameSource->getWidth();
+			sourceHeight = operation->frameSource->getHeight();
+			sourceFrames = 0;
+			newImageSet = true;
+			break;
+
 		case ScriptOperationType::SaveImage:
 			operation->initFrameOutput(FrameType::Image, basepath,
 										operation->getArgument(ArgumentLabel::Path), Constants::defaultImageExtension,
 										operation->getArgument(ArgumentLabel::Start),
-										operation->getArgument(ArgumentLabel::Length), sourceFps);
+										operation->getArgument(ArgumentLabel::Length), sourceFps, "",
+										(int)operation->getArgumentNumeric(ArgumentLabel::Queue));
 			operation->frameOutput->writeImage(getLabelOrCurrentImage(operation, image));
 			break;
 
@@ -400,7 +565,8 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 										operation->getArgument(ArgumentLabel::Path), Constants::defaultVideoExtension,
 										operation->getArgument(ArgumentLabel::Start),
 										operation->getArgument(ArgumentLabel::Length), fps,
-										operation->getArgument(ArgumentLabel::Codec));
+										operation->getArgument(ArgumentLabel::Codec),
+										(int)operation->getArgumentNumeric(ArgumentLabel::Queue));
 			operation->frameOutput->writeImage(getLabelOrCurrentImage(operation, image));
 			break;
 
@@ -414,12 +580,12 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			break;
 
 		case ScriptOperationType::GetImage:
-			*newImage = *imageList->getImage(operation->getArgument());
+			*newImage = *getImageList()->getImage(operation->imageSlot);
 			newImageSet = true;
 			break;
 
 		case ScriptOperationType::StoreImage:
-			imageList->setImage(image, operation->getArgument());
+			getImageList()->setImage(image, operation->imageSlot);
 			break;
 
 		case ScriptOperationType::Scale:
@@ -443,7 +609,7 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			break;
 
 		case ScriptOperationType::Mask:
-			ImageOperations::mask(*image, *imageList->getImage(operation->getArgument()), *newImage);
+			ImageOperations::mask(*image, *getImageList()->getImage(operation->imageSlot), *newImage);
 			newImageSet = true;
 			break;
 
@@ -524,17 +690,17 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			break;
 
 		case ScriptOperationType::Difference:
-			ImageOperations::difference(*image, *imageList->getImage(operation->getArgument()), *newImage, false);
+			ImageOperations::difference(*image, *getImageList()->getImage(operation->imageSlot), *newImage, false);
 			newImageSet = true;
 			break;
 
 		case ScriptOperationType::DifferenceAbs:
-			ImageOperations::difference(*image, *imageList->getImage(operation->getArgument()), *newImage, true);
+			ImageOperations::difference(*image, *getImageList()->getImage(operation->imageSlot), *newImage, true);
 			newImageSet = true;
 			break;
 
 		case ScriptOperationType::Add:
-			ImageOperations::add(*image, *imageList->getImage(operation->getArgument()), *newImage);
+			ImageOperations::add(*image, *getImageList()->getImage(operation->imageSlot), *newImage);
 			newImageSet = true;
 			break;
 
@@ -692,19 +858,25 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			break;
 
 		case ScriptOperationType::SaveClusters:
-			outputPath.setOutputPath(basepath, operation->getArgument(ArgumentLabel::Path), sourceFile, Constants::defaultDataExtension);
+			saveFormat = (SaveFormat)operation->getArgument(ArgumentLabel::Format, (int)SaveFormat::ByTime);
+			outputPath.setOutputPath(basepath, operation->getArgument(ArgumentLabel::Path), sourceFile,
+									 (saveFormat == SaveFormat::Binary) ? Constants::defaultBinaryDataExtension : Constants::defaultDataExtension);
 			imageTracker = imageTrackers->get(operation->getArgument(ArgumentLabel::Tracker));
-			imageTracker->saveClusters(outputPath.createFilePath(frame), frame, getTime(frame),
-										(SaveFormat)operation->getArgument(ArgumentLabel::Format, (int)SaveFormat::ByTime),
-										operation->getArgumentBoolean(ArgumentLabel::Contour));
+			imageTracker->saveClusters(getOutputFilename(outputPath.createFilePath(frame), imageTracker), frame, getTime(frame),
+										saveFormat,
+										operation->getArgumentBoolean(ArgumentLabel::Contour),
+										(ContourFormat)operation->getArgument(ArgumentLabel::ContourFormat, (int)ContourFormat::Points));
 			break;
 
 		case ScriptOperationType::SaveTracks:
-			outputPath.setOutputPath(basepath, operation->getArgument(ArgumentLabel::Path), sourceFile, Constants::defaultDataExtension);
+			saveFormat = (SaveFormat)operation->getArgument(ArgumentLabel::Format, (int)SaveFormat::ByTime);
+			outputPath.setOutputPath(basepath, operation->getArgument(ArgumentLabel::Path), sourceFile,
+									 (saveFormat == SaveFormat::Binary) ? Constants::defaultBinaryDataExtension : Constants::defaultDataExtension);
 			imageTracker = imageTrackers->get(operation->getArgument(ArgumentLabel::Tracker));
-			imageTracker->saveTracks(outputPath.createFilePath(frame), frame, getTime(frame),
-										(SaveFormat)operation->getArgument(ArgumentLabel::Format, (int)SaveFormat::ByTime),
-										operation->getArgumentBoolean(ArgumentLabel::Contour));
+			imageTracker->saveTracks(getOutputFilename(outputPath.createFilePath(frame), imageTracker), frame, getTime(frame),
+										saveFormat,
+										operation->getArgumentBoolean(ArgumentLabel::Contour),
+										(ContourFormat)operation->getArgument(ArgumentLabel::ContourFormat, (int)ContourFormat::Points));
 			break;
 
 		case ScriptOperationType::SavePaths:
@@ -719,6 +891,12 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			imageTracker->saveTrackInfo(outputPath.createFilePath(frame), frame, getTime(frame));
 			break;
 
+		case ScriptOperationType::SaveCaptureInfo:
+			outputPath.setOutputPath(basepath, operation->getArgument(ArgumentLabel::Path), sourceFile, Constants::defaultDataExtension);
+			captureInfoStream.init(outputPath.createFilePath(frame), "Frame,Time,Dropped frames\n");
+			captureInfoStream.write(Util::format("%d,%f,%d\n", frame, getTime(frame), sourceDroppedFrames));
+			break;
+
 		case ScriptOperationType::DrawLegend:
 			displayi = (int)operation->getArgumentNumeric(ArgumentLabel::Display);
 			if (displayi > 0) {
@@ -763,14 +941,22 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 				operation->imageRef = newImage;
 			}
 			operation->initialFinish();
-			processOperations(operation->innerOperations, operation);
+			if (operation->getArgumentNumeric(ArgumentLabel::Stages) > 1 || operation->getArgumentNumeric(ArgumentLabel::Branches) > 1) {
+				processPipeline(operation, (int)operation->getArgumentNumeric(ArgumentLabel::Stages),
+								(int)operation->getArgumentNumeric(ArgumentLabel::Branches));
+			} else {
+				processOperations(operation->innerOperations, operation);
+			}
+		}
+		if (resetSource) {
+			operation->resetFrameSource();
 		}
 
 		if (operation->asignee != "") {
 			if (newImageSet) {
-				imageList->setImage(newImage, operation->asignee);
+				getImageList()->setImage(newImage, operation->asigneeSlot);
 			} else {
-				imageList->setImage(image, operation->asignee);
+				getImageList()->setImage(image, operation->asigneeSlot);
 			}
 		} else {
 			if (newImageSet) {
@@ -800,20 +986,803 @@ bool ScriptProcessing::processOperation(ScriptOperation* operation, ScriptOperat
 			errorMsg += " (Image depth/types don't match)";
 		}
 		errorMsg += " in\n" + operation->line;
+		if (stageImageList) {
+			// pipeline stage: pass on to main processing
+			throw runtime_error(errorMsg);
+		}
 		showDialog(errorMsg, MessageLevel::Error);
 		doReset();
     } catch (std::exception& e) {
 		errorMsg = Util::getExceptionDetail(e) + " in\n" + operation->line;
+		if (stageImageList) {
+			// pipeline stage: pass on to main processing
+			throw runtime_error(errorMsg);
+		}
 		showDialog(errorMsg, MessageLevel::Error);
 		doReset();
 	}
 	return done;
 }
 
+void ScriptProcessing::processPipeline(ScriptOperation* operation, int nstages, int nbranches) {
+	FrameItem item;
+
+	if (!operation->pipeline) {
+		startPipeline(operation, nstages, nbranches);
+	}
+
+	if (operation->imageRef && operation->operationType == ScriptOperationType::OpenSharedMemory) {
+		// frame refers to ring slot, which can be overwritten while frames are in flight: copy
+		item.image = operation->imageRef->clone();
+	} else if (operation->imageRef) {
+		item.image = *operation->imageRef;
+		if (operation->imageRef == &operation->image) {
+			// frame handed over; source reads next frame into new image
+			operation->image.release();
+		}
+	}
+	item.framei = sourceFrameNumber;
+	item.time = sourceFrameTime;
+	item.dropped = sourceDroppedFrames;
+	operation->pipeline->push(item);
+}
+
+void ScriptProcessing::startPipeline(ScriptOperation* sourceOperation, int nstages, int nbranches) {
+	vector<ScriptOperation*> operations = sourceOperation->innerOperations->getOperations();
+	vector<function<void(FrameItem&)>> stageMethods;
+	vector<shared_ptr<PipelineStage>> stages;
+	shared_ptr<PipelineStage> stage;
+	map<string, pair<int, int>> resourceRanges;
+	vector<bool> cutAllowed(operations.size() + 1, true);
+	vector<int> cuts;
+	vector<int> storedStage(imageList->getSlotCount(), -1);
+	vector<int> lastUsedStage(imageList->getSlotCount(), -1);
+	vector<int> firstUsed(imageList->getSlotCount(), -1);
+	vector<int> lastStored(imageList->getSlotCount(), -1);
+	ScriptOperation* operation;
+	int noperations = (int)operations.size();
+	int target, cut, slot;
+
+	if (sourceOperation->asigneeSlot >= 0) {
+		throw invalid_argument("Assigning source not supported with 'Stages' or 'Branches' in\n" + sourceOperation->line);
+	}
+
+	// operations using same shared state (tracker, buffers, stored image) in same stage: processed in frame order
+	for (int operationi = 0; operationi < noperations; operationi++) {
+		operation = operations[operationi];
+		for (string resource : getPipelineResources(operation)) {
+			if (resourceRanges.count(resource) == 0) {
+				resourceRanges[resource] = { operationi, operationi };
+			}
+			resourceRanges[resource].second = operationi;
+		}
+		for (int sloti = 0; sloti < 2; sloti++) {
+			slot = (sloti == 0) ? operation->imageSlot : operation->asigneeSlot;
+			if (slot >= 0) {
+				if (firstUsed[slot] < 0) {
+					firstUsed[slot] = operationi;
+				}
+				if (sloti == 1 || operation->operationType == ScriptOperationType::StoreImage) {
+					lastStored[slot] = operationi;
+				}
+			}
+		}
+	}
+	// image used before stored (previous frame): all its uses in same stage
+	for (int operationi = 0; operationi < noperations; operationi++) {
+		slot = operations[operationi]->imageSlot;
+		if (slot >= 0 && operations[operationi]->operationType != ScriptOperationType::StoreImage && operationi < lastStored[slot]) {
+			resourceRanges["image" + to_string(slot)] = { firstUsed[slot], lastStored[slot] };
+		}
+	}
+	for (auto& resourceRange : resourceRanges) {
+		for (int operationi = resourceRange.second.first + 1; operationi <= resourceRange.second.second; operationi++) {
+			cutAllowed[operationi] = false;
+		}
+	}
+
+	// cut at allowed positions, closest to equal number of operations per stage
+	cuts.push_back(0);
+	for (int stagei = 1; stagei < nstages; stagei++) {
+		target = (int)round((double)noperations * stagei / nstages);
+		cut = -1;
+		for (int operationi = cuts.back() + 1; operationi < noperations; operationi++) {
+			if (cutAllowed[operationi] && (cut < 0 || abs(operationi - target) < abs(cut - target))) {
+				cut = operationi;
+			}
+		}
+		if (cut < 0) {
+			break;
+		}
+		cuts.push_back(cut);
+	}
+	cuts.push_back(noperations);
+
+	for (int stagei = 0; stagei + 1 < cuts.size(); stagei++) {
+		stage = make_shared<PipelineStage>();
+		stage->operations.assign(operations.begin() + cuts[stagei], operations.begin() + cuts[stagei + 1]);
+		stage->images.copySlots(imageList);
+		for (int operationi = cuts[stagei]; operationi < cuts[stagei + 1]; operationi++) {
+			operation = operations[operationi];
+			if (operation->operationType == ScriptOperationType::StoreImage) {
+				storedStage[operation->imageSlot] = stagei;
+			} else if (operation->imageSlot >= 0) {
+				lastUsedStage[operation->imageSlot] = stagei;
+			}
+			if (operation->asigneeSlot >= 0) {
+				storedStage[operation->asigneeSlot] = stagei;
+			}
+		}
+		if (nbranches > 1) {
+			startBranches(stage.get(), nbranches);
+		}
+		stages.push_back(stage);
+		stageMethods.push_back([this, stage](FrameItem& item) {
+			processStage(stage.get(), item);
+		});
+	}
+
+	// stored images handed over to next stages using them
+	for (int slot = 0; slot < storedStage.size(); slot++) {
+		if (storedStage[slot] >= 0 && lastUsedStage[slot] > storedStage[slot]) {
+			stages[storedStage[slot]]->outputSlots.push_back(slot);
+			for (int stagei = storedStage[slot] + 1; stagei <= lastUsedStage[slot]; stagei++) {
+				stages[stagei]->inputSlots.push_back(slot);
+			}
+		}
+	}
+
+	sourceOperation->pipeline = new FramePipeline();
+	sourceOperation->pipeline->start(stageMethods, Constants::pipelineQueueSize);
+}
+
+void ScriptProcessing::processStage(PipelineStage* stage, FrameItem& item) {
+	ScriptOperation* prevOperation = &stage->input;
+	Mat* output;
+
+	// frame state of this thread
+	sourceFrameNumber = item.framei;
+	sourceFrameTime = item.time;
+	sourceDroppedFrames = item.dropped;
+	stageImageList = &stage->images;
+	stage->images.setImages(item.images, stage->inputSlots);
+
+	stage->input.imageRef = &item.image;
+	if (stage->graph) {
+		stage->item = &item;
+		stage->graph->run();
+		output = stage->outputOperation->imageRef;
+	} else {
+		for (ScriptOperation* operation : stage->operations) {
+			operation->reset();
+			processOperation(operation, prevOperation);
+			operation->finish();
+			prevOperation = operation;
+		}
+		output = prevOperation->imageRef;
+	}
+
+	// hand over copies: operation images are reused for next frame
+	if (!output) {
+		item.image.release();
+	} else if (output != &item.image) {
+		item.image = output->clone();
+	}
+	stage->images.getImages(&item.images, stage->outputSlots);
+}
+
+void ScriptProcessing::startBranches(PipelineStage* stage, int nbranches) {
+	map<string, int> lastWriters;
+	map<string, vector<int>> readers;
+	vector<string> resources, sharedResources;
+	vector<int> firstRead(imageList->getSlotCount(), -1);
+	ScriptOperation* operation;
+	ScriptOperation* outputOperation = &stage->input;
+	int noperations = (int)stage->operations.size();
+	int outputi = -1;
+	int slot;
+	bool readsImage, setsImage;
+	string slotResource;
+
+	// image used before stored (previous frame) can refer to image of operation processed later in frame: process in order
+	for (int operationi = 0; operationi < noperations; operationi++) {
+		operation = stage->operations[operationi];
+		for (int sloti = 0; sloti < 2; sloti++) {
+			slot = (sloti == 0) ? operation->imageSlot : operation->asigneeSlot;
+			if (slot < 0) {
+				continue;
+			}
+			if (sloti == 1 || operation->operationType == ScriptOperationType::StoreImage) {
+				if (firstRead[slot] >= 0 && firstRead[slot] < operationi) {
+					return;
+				}
+			} else if (firstRead[slot] < 0) {
+				firstRead[slot] = operationi;
+			}
+		}
+	}
+
+	stage->graph = new TaskGraph();
+	stage->graph->start(noperations, [this, stage](int operationi) {
+		processBranch(stage, operationi);
+	}, nbranches);
+	stage->inputOperations.assign(noperations, &stage->input);
+
+	for (int operationi = 0; operationi < noperations; operationi++) {
+		operation = stage->operations[operationi];
+
+		// current image: from last operation setting it
+		getImageUse(operation, &readsImage, &setsImage);
+		if (readsImage) {
+			stage->inputOperations[operationi] = outputOperation;
+			stage->graph->addDependency(operationi, outputi);
+		}
+		if (setsImage) {
+			outputOperation = operation;
+			outputi = operationi;
+		}
+
+		// shared state and stored images: used in script order, except concurrent reads
+		resources = getPipelineResources(operation);
+		sharedResources = getSharedResources(operation);
+		if (operation->imageSlot >= 0 && operation->operationType != ScriptOperationType::StoreImage) {
+			slotResource = "store" + to_string(operation->imageSlot);
+			if (find(resources.begin(), resources.end(), slotResource) == resources.end()) {
+				resources.push_back(slotResource);
+				sharedResources.push_back(slotResource);
+			}
+		}
+		for (string resource : resources) {
+			if (lastWriters.count(resource) > 0) {
+				stage->graph->addDependency(operationi, lastWriters[resource]);
+			}
+			if (find(sharedResources.begin(), sharedResources.end(), resource) != sharedResources.end()) {
+				readers[resource].push_back(operationi);
+			} else {
+				for (int readeri : readers[resource]) {
+					stage->graph->addDependency(operationi, readeri);
+				}
+				readers[resource].clear();
+				lastWriters[resource] = operationi;
+			}
+		}
+	}
+	stage->outputOperation = outputOperation;
+}
+
+void ScriptProcessing::processBranch(PipelineStage* stage, int operationi) {
+	ScriptOperation* operation = stage->operations[operationi];
+
+	// frame state of this thread
+	sourceFrameNumber = stage->item->framei;
+	sourceFrameTime = stage->item->time;
+	sourceDroppedFrames = stage->item->dropped;
+	stageImageList = &stage->images;
+
+	operation->reset();
+	processOperation(operation, stage->inputOperations[operationi]);
+	operation->finish();
+}
+
+vector<string> ScriptProcessing::getPipelineResources(ScriptOperation* operation) {
+	vector<string> resources;
+
+	if (operation->hasInnerOperations()) {
+		throw invalid_argument("Operation blocks not supported with 'Stages' or 'Branches' in\n" + operation->line);
+	}
+
+	switch (operation->operationType) {
+	case ScriptOperationType::SetBackground:
+	case ScriptOperationType::UpdateBackground:
+		resources.push_back("background");
+		break;
+
+	case ScriptOperationType::UpdateWeight:
+	case ScriptOperationType::UpdateMin:
+	case ScriptOperationType::UpdateMax:
+		resources.push_back("buffer");
+		break;
+
+	case ScriptOperationType::AddSeries:
+	case ScriptOperationType::ClearSeries:
+	case ScriptOperationType::GetSeriesMean:
+	case ScriptOperationType::GetSeriesMedian:
+		resources.push_back("series");
+		break;
+
+	case ScriptOperationType::AddAccum:
+		resources.push_back("accum");
+		break;
+
+	case ScriptOperationType::GetAccum:
+		resources.push_back("accum");
+		resources.push_back("palette");
+		break;
+
+	case ScriptOperationType::DrawLegend:
+		resources.push_back("palette");
+		break;
+
+	case ScriptOperationType::OpticalCalibration:
+	case ScriptOperationType::OpticalCorrection:
+		resources.push_back("optical");
+		break;
+
+	case ScriptOperationType::DrawPaths:
+		resources.push_back("palette");
+		resources.push_back("tracker:" + operation->getArgument(ArgumentLabel::Tracker));
+		break;
+
+	case ScriptOperationType::CreateClusters:
+	case ScriptOperationType::CreateTracks:
+	case ScriptOperationType::CreatePaths:
+	case ScriptOperationType::DrawClusters:
+	case ScriptOperationType::DrawTracks:
+	case ScriptOperationType::DrawTrackCount:
+	case ScriptOperationType::ShowTrackInfo:
+		resources.push_back("tracker:" + operation->getArgument(ArgumentLabel::Tracker));
+		break;
+
+	case ScriptOperationType::SaveClusters:
+	case ScriptOperationType::SaveTracks:
+	case ScriptOperationType::SavePaths:
+	case ScriptOperationType::SaveTrackInfo:
+		resources.push_back("tracker:" + operation->getArgument(ArgumentLabel::Tracker));
+		resources.push_back("trackeroutput:" + operation->getArgument(ArgumentLabel::Tracker));
+		break;
+
+	case ScriptOperationType::SaveCaptureInfo:
+		resources.push_back("captureinfo");
+		break;
+
+	case ScriptOperationType::Set:
+	case ScriptOperationType::SetPath:
+	case ScriptOperationType::Source:
+	case ScriptOperationType::CreateImage:
+	case ScriptOperationType::OpenImage:
+	case ScriptOperationType::OpenStack:
+	case ScriptOperationType::OpenVideo:
+	case ScriptOperationType::OpenCapture:
+	case ScriptOperationType::OpenPipe:
+	case ScriptOperationType::OpenSharedMemory:
+	case ScriptOperationType::Pause:
+	case ScriptOperationType::Benchmark:
+		throw invalid_argument("Operation not supported with 'Stages' or 'Branches' in\n" + operation->line);
+
+	default:
+		break;
+	}
+
+	// image stored in one stage
+	if (operation->operationType == ScriptOperationType::StoreImage) {
+		resources.push_back("store" + to_string(operation->imageSlot));
+	}
+	if (operation->asigneeSlot >= 0) {
+		resources.push_back("store" + to_string(operation->asigneeSlot));
+	}
+	return resources;
+}
+
+vector<string> ScriptProcessing::getSharedResources(ScriptOperation* operation) {
+	vector<string> resources;
+
+	switch (operation->operationType) {
+	case ScriptOperationType::DrawClusters:
+	case ScriptOperationType::DrawTracks:
+	case ScriptOperationType::DrawTrackCount:
+	case ScriptOperationType::ShowTrackInfo:
+	case ScriptOperationType::SaveClusters:
+	case ScriptOperationType::SaveTracks:
+	case ScriptOperationType::SavePaths:
+	case ScriptOperationType::SaveTrackInfo:
+		resources.push_back("tracker:" + operation->getArgument(ArgumentLabel::Tracker));
+		break;
+
+	default:
+		break;
+	}
+	return resources;
+}
+
+void ScriptProcessing::getImageUse(ScriptOperation* operation, bool* reads, bool* sets) {
+	*reads = false;
+	*sets = false;
+
+	switch (operation->operationType) {
+	case ScriptOperationType::GetImage:
+	case ScriptOperationType::GetAccum:
+		*sets = true;
+		break;
+
+	case ScriptOperationType::SaveImage:
+	case ScriptOperationType::SaveVideo:
+	case ScriptOperationType::ShowImage:
+	case ScriptOperationType::StoreImage:
+	case ScriptOperationType::SetBackground:
+	case ScriptOperationType::AddSeries:
+	case ScriptOperationType::AddAccum:
+	case ScriptOperationType::CreateClusters:
+		*reads = true;
+		break;
+
+	case ScriptOperationType::Scale:
+	case ScriptOperationType::Crop:
+	case ScriptOperationType::Mask:
+	case ScriptOperationType::Grayscale:
+	case ScriptOperationType::Color:
+	case ScriptOperationType::ColorAlpha:
+	case ScriptOperationType::Int:
+	case ScriptOperationType::Float:
+	case ScriptOperationType::GetHue:
+	case ScriptOperationType::GetSaturation:
+	case ScriptOperationType::GetHsValue:
+	case ScriptOperationType::GetHsLightness:
+	case ScriptOperationType::Threshold:
+	case ScriptOperationType::InRangeHsv:
+	case ScriptOperationType::Erode:
+	case ScriptOperationType::Dilate:
+	case ScriptOperationType::Difference:
+	case ScriptOperationType::DifferenceAbs:
+	case ScriptOperationType::Add:
+	case ScriptOperationType::Multiply:
+	case ScriptOperationType::Invert:
+	case ScriptOperationType::UpdateBackground:
+	case ScriptOperationType::UpdateWeight:
+	case ScriptOperationType::UpdateMin:
+	case ScriptOperationType::UpdateMax:
+	case ScriptOperationType::OpticalCorrection:
+	case ScriptOperationType::DrawClusters:
+	case ScriptOperationType::DrawTracks:
+	case ScriptOperationType::DrawPaths:
+	case ScriptOperationType::DrawTrackCount:
+	// new image not always set: current image passed on
+	case ScriptOperationType::GetSeriesMedian:
+	case ScriptOperationType::GetSeriesMean:
+	case ScriptOperationType::OpticalCalibration:
+	case ScriptOperationType::DrawLegend:
+		*reads = true;
+		*sets = true;
+		break;
+
+	default:
+		break;
+	}
+
+	if (operation->interval > 1) {
+		// not processed every frame: current image passed on
+		*reads = true;
+		*sets = true;
+	}
+	if (operation->asigneeSlot >= 0) {
+		// image stored instead of set
+		*reads = true;
+		*sets = false;
+	}
+}
+
+ImageItemList* ScriptProcessing::getImageList() {
+	if (stageImageList) {
+		return stageImageList;
+	}
+	return imageList;
+}
+
+void ScriptProcessing::processSegments(ScriptOperation* operation, string source, int nworkers) {
+	vector<ScriptProcessing*> workers;
+	vector<WorkerObserver*> workerObservers;
+	vector<std::thread*> workerThreads;
+	vector<int> segmentStarts;
+	map<string, double> outputs;
+	ScriptProcessing* worker;
+	WorkerObserver* workerObserver;
+	string script = scriptOperations->getScript();
+	string error;
+	int start, end, interval, overlap;
+	int progress, total, nfinished;
+
+	checkSegmentOperations(operation);
+
+	// determine frame range
+	operation->initFrameSource(FrameType::Video, basepath, source,
+								(int)operation->getArgumentNumeric(ArgumentLabel::API), operation->getArgument(ArgumentLabel::Codec),
+								operation->getArgument(ArgumentLabel::Start),
+								operation->getArgument(ArgumentLabel::Length), 0,
+								(int)operation->getArgumentNumeric(ArgumentLabel::Interval),
+								(int)operation->getArgumentNumeric(ArgumentLabel::Total));
+	start = operation->frameSource->getStart();
+	end = operation->frameSource->getEnd();
+	interval = operation->frameSource->getInterval();
+	sourceFps = operation->frameSource->getFps();
+	sourceWidth = operation->frameSource->getWidth();
+	sourceHeight = operation->frameSource->getHeight();
+	sourceFrames = operation->frameSource->getTotalFrames();
+	operation->resetFrameSource();
+	if (end <= start) {
+		throw invalid_argument("Source length unknown, 'Workers' not supported");
+	}
+
+	// segments aligned to interval; overlap to settle tracking before start of segment
+	overlap = max((int)ceil(sourceFps * Constants::segmentOverlapTime / interval), 1) * interval;
+	for (int segmenti = 0; segmenti < nworkers; segmenti++) {
+		segmentStarts.push_back(start + (int)((double)(end - start) / nworkers * segmenti / interval) * interval);
+	}
+	segmentStarts.push_back(end);
+
+	for (int segmenti = 0; segmenti < nworkers; segmenti++) {
+		workerObserver = new WorkerObserver();
+		worker = createWorker(operation, script, workerObserver);
+		worker->segmenti = segmenti;
+		worker->segmentStart = max(segmentStarts[segmenti] - overlap, start);
+		worker->segmentEnd = segmentStarts[segmenti + 1];
+		worker->segmentInterval = interval;
+		workerObservers.push_back(workerObserver);
+		workers.push_back(worker);
+	}
+
+	for (int workeri = 0; workeri < nworkers; workeri++) {
+		worker = workers[workeri];
+		workerObserver = workerObservers[workeri];
+		workerThreads.push_back(new std::thread([worker, workerObserver] {
+			worker->processWorkerMethod();
+			workerObserver->finished = true;
+		}));
+	}
+
+	// aggregate progress
+	do {
+		this_thread::sleep_for(100ms);
+		progress = 0;
+		total = 0;
+		nfinished = 0;
+		for (int workeri = 0; workeri < nworkers; workeri++) {
+			if (operationMode == OperationMode::Abort) {
+				workers[workeri]->requestAbort();
+			}
+			progress += workerObservers[workeri]->progress;
+			total += workerObservers[workeri]->total;
+			if (workerObservers[workeri]->finished) {
+				nfinished++;
+			}
+		}
+		showStatus(progress, total, getSourceLabel());
+	} while (nfinished < nworkers);
+
+	for (int workeri = 0; workeri < nworkers; workeri++) {
+		workerThreads[workeri]->join();
+		delete workerThreads[workeri];
+		if (error == "") {
+			error = workerObservers[workeri]->getError();
+		}
+		for (auto& output : workers[workeri]->segmentOutputs) {
+			outputs[output.first] = max(outputs[output.first], output.second);
+		}
+		delete workers[workeri];
+		delete workerObservers[workeri];
+	}
+
+	if (error != "") {
+		throw runtime_error(error);
+	}
+	if (operationMode != OperationMode::Abort) {
+		for (auto& output : outputs) {
+			TrackStitcher::stitch(output.first, segmentStarts, overlap, output.second);
+		}
+	}
+}
+
+void ScriptProcessing::processSources(ScriptOperation* operation, int nworkers) {
+	NumericPath sourcePath;
+	vector<std::thread*> workerThreads;
+	vector<ScriptProcessing*> workers(nworkers, nullptr);
+	mutex workersMutex;
+	string script = scriptOperations->getScript();
+	string error;
+	atomic<int> nextFilei = 0;
+	atomic<int> nfinished = 0;
+	atomic<int> nfinishedThreads = 0;
+	atomic<bool> aborted = false;
+	int nfiles;
+
+	checkWorkerOperation(operation);
+
+	sourcePath.setInputPath(basepath, operation->getArgument(ArgumentLabel::Path));
+	nfiles = sourcePath.getFileCount();
+	observer->resetProgressTimer();
+
+	// worker pool: each file processed in new context, starting at this operation with copy of current state
+	for (int threadi = 0; threadi < nworkers; threadi++) {
+		workerThreads.push_back(new std::thread([&, threadi] {
+			WorkerObserver workerObserver;
+			ScriptProcessing* worker;
+			string workerError;
+			int filei;
+
+			while (!aborted && (filei = nextFilei++) < nfiles) {
+				try {
+					worker = createWorker(operation, script, &workerObserver);
+					worker->sourceFilei = filei;
+					worker->workerSourcei = filei;
+					{
+						lock_guard<mutex> lock(workersMutex);
+						workers[threadi] = worker;
+					}
+					worker->processWorkerMethod();
+					{
+						lock_guard<mutex> lock(workersMutex);
+						workers[threadi] = nullptr;
+					}
+					delete worker;
+					workerError = workerObserver.getError();
+				} catch (exception& e) {
+					workerError = Util::getExceptionDetail(e);
+				}
+				if (workerError != "") {
+					lock_guard<mutex> lock(workersMutex);
+					if (error == "") {
+						error = workerError;
+					}
+					aborted = true;
+				}
+				nfinished++;
+			}
+			nfinishedThreads++;
+		}));
+	}
+
+	// aggregate progress
+	do {
+		this_thread::sleep_for(100ms);
+		if (operationMode == OperationMode::Abort || aborted) {
+			aborted = true;
+			lock_guard<mutex> lock(workersMutex);
+			for (ScriptProcessing* worker : workers) {
+				if (worker) {
+					worker->requestAbort();
+				}
+			}
+		}
+		showStatus(nfinished, nfiles);
+	} while (nfinishedThreads < nworkers);
+
+	for (std::thread* workerThread : workerThreads) {
+		workerThread->join();
+		delete workerThread;
+	}
+
+	if (error != "") {
+		throw runtime_error(error);
+	}
+}
+
+void ScriptProcessing::extractScript(string script) {
+	scriptOperations->extract(script);
+	scriptOperations->assignImageSlots(imageList);
+	imageList->checkSlots();
+}
+
+ScriptProcessing* ScriptProcessing::createWorker(ScriptOperation* operation, string script, WorkerObserver* workerObserver) {
+	ScriptProcessing* worker = new ScriptProcessing();
+
+	worker->registerObserver(workerObserver);
+	worker->useGui = false;
+	worker->basepath = basepath;
+	worker->workerLine = operation->lineStart;
+	worker->extractScript(script);
+	// start at worker operation: preceding operations already processed by main processing
+	if (!worker->scriptOperations->setCurrentOperation(worker->scriptOperations->getOperation(operation->lineStart))) {
+		delete worker;
+		throw invalid_argument("'Workers' only supported outside other operation blocks");
+	}
+	copyState(worker);
+	worker->operationMode = OperationMode::Run;
+	return worker;
+}
+
+void ScriptProcessing::copyState(ScriptProcessing* worker) {
+	vector<Mat> images;
+	vector<int> slots;
+
+	worker->sourceFile = sourceFile;
+	worker->sourceFilei = sourceFilei;
+	worker->nsourceFiles = nsourceFiles;
+	worker->sourceWidth = (int)sourceWidth;
+	worker->sourceHeight = (int)sourceHeight;
+	worker->sourceFps = (double)sourceFps;
+	worker->sourceFrames = (int)sourceFrames;
+	worker->pixelSize = pixelSize;
+	worker->windowSize = windowSize;
+	worker->logPower = logPower;
+	worker->logPalette = logPalette;
+	worker->medianMode = medianMode;
+
+	// copies: workers process concurrently
+	for (int slot = 0; slot < imageList->getSlotCount(); slot++) {
+		slots.push_back(slot);
+	}
+	imageList->getImages(&images, slots);
+	worker->imageList->setImages(images, slots);
+
+	worker->backgroundBuffer->bufferImage = backgroundBuffer->bufferImage.clone();
+	worker->backgroundBuffer->set = backgroundBuffer->set;
+	worker->simpleBuffer->bufferImage = simpleBuffer->bufferImage.clone();
+	worker->simpleBuffer->set = simpleBuffer->set;
+	*worker->imageSeries = *imageSeries;
+	worker->accumBuffer->bufferImage = accumBuffer->bufferImage.clone();
+	worker->accumBuffer->helpImage = accumBuffer->helpImage.clone();
+	worker->accumBuffer->accumMode = accumBuffer->accumMode;
+	worker->accumBuffer->total = accumBuffer->total;
+	worker->accumBuffer->set = accumBuffer->set;
+	worker->opticalCorrection->map1 = opticalCorrection->map1.clone();
+	worker->opticalCorrection->map2 = opticalCorrection->map2.clone();
+	worker->opticalCorrection->calibrated = opticalCorrection->calibrated;
+	// trackers: new per worker (segment tracking settles in overlap)
+}
+
+void ScriptProcessing::checkWorkerOperation(ScriptOperation* workerOperation) {
+	ScriptOperation* operation;
+
+	// workers start at this operation (root level), with state of main processing
+	for (int linei = 0; linei < workerOperation->lineStart; linei++) {
+		operation = scriptOperations->getOperation(linei);
+		if (operation && operation->lineEnd >= workerOperation->lineStart) {
+			throw invalid_argument("'Workers' only supported outside other operation blocks");
+		}
+	}
+}
+
+void ScriptProcessing::checkSegmentOperations(ScriptOperation* segmentOperation) {
+	ScriptOperation* operation;
+	SaveFormat format;
+
+	checkWorkerOperation(segmentOperation);
+
+	// inner operations are mapped by script line
+	for (int linei = segmentOperation->lineStart + 1; linei <= segmentOperation->lineEnd; linei++) {
+		operation = scriptOperations->getOperation(linei);
+		if (operation) {
+			switch (operation->operationType) {
+			case ScriptOperationType::SaveClusters:
+			case ScriptOperationType::SaveTracks:
+				format = (SaveFormat)operation->getArgument(ArgumentLabel::Format, (int)SaveFormat::ByTime);
+				if (format != SaveFormat::ByTime) {
+					throw invalid_argument("Only format " + SaveFormats[(int)SaveFormat::ByTime] + " supported with 'Workers' in\n" + operation->line);
+				}
+				break;
+
+			case ScriptOperationType::Source:
+			case ScriptOperationType::OpenImage:
+			case ScriptOperationType::OpenStack:
+			case ScriptOperationType::OpenVideo:
+			case ScriptOperationType::OpenCapture:
+			case ScriptOperationType::OpenPipe:
+			case ScriptOperationType::OpenSharedMemory:
+			case ScriptOperationType::SaveImage:
+			case ScriptOperationType::SaveVideo:
+			case ScriptOperationType::SavePaths:
+			case ScriptOperationType::SaveTrackInfo:
+			case ScriptOperationType::SaveCaptureInfo:
+				throw invalid_argument("Operation not supported with 'Workers' in\n" + operation->line);
+
+			default:
+				break;
+			}
+		}
+	}
+}
+
+string ScriptProcessing::getOutputFilename(string filename, ImageTracker* imageTracker) {
+	if (segmenti >= 0) {
+		// worker: write segment part, to be stitched by main processing
+		lock_guard<mutex> lock(segmentOutputsMutex);
+		segmentOutputs[filename] = max(segmentOutputs[filename], imageTracker->getMaxMoveDistance());
+		return TrackStitcher::getPartFilename(filename, segmenti);
+	}
+	return filename;
+}
+
 Mat* ScriptProcessing::getLabelOrCurrentImage(ScriptOperation* operation, Mat* currentImage) {
-	Mat* image;
-	string label = operation->getArgument(ArgumentLabel::Label);
-	image = imageList->getImage(label, false);
+	Mat* image = getImageList()->getImage(operation->imageSlot, false);
+
 	if (!Util::isValidImage(image)) {
 		image = currentImage;
 	}
@@ -826,7 +1795,10 @@ OperationMode ScriptProcessing::getMode() {
 
 double ScriptProcessing::getTime(int frame) {
 	double time;
-	if (sourceFps > 0) {
+	if (sourceFrameTime >= 0) {
+		// live source: actual capture time
+		time = sourceFrameTime;
+	} else if (sourceFps > 0) {
 		time = frame / sourceFps;
 	} else {
 		time = frame;
@@ -855,14 +1827,27 @@ void ScriptProcessing::requestAbort() {
 }
 
 void ScriptProcessing::doReset(bool completed) {
+	string statistics;
+
 	if (completed) {
 		showStatus(1, 1);
 	} else {
 		observer->clearStatus();
 	}
-	imageTrackers->close();
+	// close operations first: stops any pipeline stages
 	scriptOperations->close();
+	imageTrackers->close();
+	captureInfoStream.reset();
+	statistics = scriptOperations->getOutputStatistics();
+	if (statistics != "") {
+		showText(statistics, Constants::nTextWindows);
+	}
 	reset();
+	if (workerLine < 0) {
+		// images released; workers share cache maps with main processing
+		FrameCache::releaseMaps();
+		SharedMemorySource::releaseMaps();
+	}
 	setMode(OperationMode::Idle);
 }
 
@@ -872,29 +1857,40 @@ void ScriptProcessing::setMode(OperationMode mode) {
 }
 
 void ScriptProcessing::showStatus(int i, int tot, string label) {
+	// pipeline stages report concurrently
+	lock_guard<mutex> lock(observerMutex);
+
 	if (observer->checkStatusProcess()) {
 		observer->showStatus(i, tot, label);
 	}
 }
 
 void ScriptProcessing::showText(string text, int displayi, string reference) {
+	lock_guard<mutex> lock(observerMutex);
+
 	if (observer->checkTextProcess(displayi)) {
 		observer->showText(text, displayi, reference);
 	}
 }
 
 void ScriptProcessing::showImage(Mat* image, int displayi, string reference) {
+	lock_guard<mutex> lock(observerMutex);
+
 	if (observer->checkImageProcess(displayi)) {
 		observer->showImage(image, displayi, reference);
 	}
 }
 
 void ScriptProcessing::showDialog(string message, MessageLevel level) {
+	lock_guard<mutex> lock(observerMutex);
+
 	cout << "\n" + MessageLevels[(int)level] + " " + message << endl;
 	observer->showDialog(message, (int)level);
 }
 
 void ScriptProcessing::showOperations(ScriptOperations* operations, ScriptOperation* currentOperation) {
+	lock_guard<mutex> lock(observerMutex);
+
 	if (observer->checkOperationsProcess()) {
 		observer->showOperations(operations, currentOperation);
 	}
@@ -9,6 +9,10 @@
 
 #pragma once
 #include <thread>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
 #ifndef _CONSOLE
 #include <QObject>
 #endif
@@ -22,6 +26,31 @@
 #include "AccumBuffer.h"
 #include "OpticalCorrection.h"
 #include "ImageTrackers.h"
+#include "TaskGraph.h"
+#include "WorkerObserver.h"
+
+
+/*
+ * Pipeline stage: consecutive operations of a block, processed in own thread
+ */
+
+class PipelineStage
+{
+public:
+	vector<ScriptOperation*> operations;
+	vector<int> inputSlots;		// image slots stored by previous stages
+	vector<int> outputSlots;	// image slots stored by this stage, used by next stages
+	ImageItemList images;		// own image slots
+	ScriptOperation input;		// previous operation of first operation, referring to input image
+
+	// branches: independent operations processed concurrently
+	TaskGraph* graph = nullptr;
+	vector<ScriptOperation*> inputOperations;	// operation referring to input image, per operation
+	ScriptOperation* outputOperation = nullptr;	// operation referring to output image
+	FrameItem* item = nullptr;					// frame being processed
+
+	~PipelineStage();
+};
 
 
 /*
@@ -50,11 +79,16 @@ public:
 	string sourceFile;
 	int sourceFilei = 0;
 	int nsourceFiles = 0;
-	int sourceWidth = 0;
-	int sourceHeight = 0;
-	double sourceFps = 0;
-	int sourceFrames = 0;
-	int sourceFrameNumber = 0;
+	atomic<int> sourceWidth = 0;
+	atomic<int> sourceHeight = 0;
+	atomic<double> sourceFps = 0;
+	atomic<int> sourceFrames = 0;
+	// current frame: per thread, as pipeline stages process different frames concurrently
+	static thread_local int sourceFrameNumber;
+	static thread_local double sourceFrameTime;
+	static thread_local int sourceDroppedFrames;
+	static thread_local ImageItemList* stageImageList;
+	OutputStream captureInfoStream;
 	double pixelSize = 1;
 	double windowSize = 1;
 	double logPower = 0;
@@ -62,6 +96,17 @@ public:
 	MedianMode medianMode = MedianMode::Normal;
 	OperationMode operationMode = OperationMode::Idle;
 	bool useGui = true;
+	mutex observerMutex;
+
+	// parallel worker: script line of operation to process (-1: main processing)
+	int workerLine = -1;
+	int workerSourcei = -1;
+	int segmenti = -1;
+	int segmentStart = 0;
+	int segmentEnd = 0;
+	int segmentInterval = 1;
+	map<string, double> segmentOutputs;		// output file, max distance of matching tracks
+	mutex segmentOutputsMutex;
 
 
 	ScriptProcessing();
@@ -79,6 +124,7 @@ public:
 	bool startProcessNoGui(string scriptFilename);
 	bool startProcess(string filepath, string script);
 	void processThreadMethod();
+	void processWorkerMethod();
 
 	/*
 	 * Main script loop - called recursively for { internal } loops
@@ -89,6 +135,63 @@ public:
 	 * Process single script operation
 	 */
 	bool processOperation(ScriptOperation* operation, ScriptOperation* prevOperation);
+
+	/*
+	 * Process inner operations of source in pipeline stages, each in own thread, with several frames in flight
+	 */
+	void processPipeline(ScriptOperation* operation, int nstages, int nbranches);
+	void startPipeline(ScriptOperation* sourceOperation, int nstages, int nbranches);
+	void processStage(PipelineStage* stage, FrameItem& item);
+
+	/*
+	 * Dependency graph of stage operations, from current image, stored images and shared state; independent operations processed concurrently
+	 */
+	void startBranches(PipelineStage* stage, int nbranches);
+	void processBranch(PipelineStage* stage, int operationi);
+
+	/*
+	 * Shared state used by operation; operations using same state are kept in same pipeline stage
+	 */
+	vector<string> getPipelineResources(ScriptOperation* operation);
+
+	/*
+	 * Shared state only read by operation: can be used by several operations concurrently
+	 */
+	vector<string> getSharedResources(ScriptOperation* operation);
+
+	/*
+	 * If operation reads current image, and if it can set new current image
+	 */
+	void getImageUse(ScriptOperation* operation, bool* reads, bool* sets);
+
+	/*
+	 * Image slots of current thread (pipeline stage)
+	 */
+	ImageItemList* getImageList();
+
+	/*
+	 * Process source files concurrently, each in its own worker context
+	 */
+	void processSources(ScriptOperation* operation, int nworkers);
+
+	/*
+	 * Process video in time segments using parallel workers, and stitch their output
+	 */
+	void processSegments(ScriptOperation* operation, string source, int nworkers);
+
+	/*
+	 * Extract script operations, and resolve image labels to image slots
+	 */
+	void extractScript(string script);
+	ScriptProcessing* createWorker(ScriptOperation* operation, string script, WorkerObserver* workerObserver);
+
+	/*
+	 * Copy settings, stored images and buffers to worker, instead of worker processing script up to worker operation
+	 */
+	void copyState(ScriptProcessing* worker);
+	void checkWorkerOperation(ScriptOperation* workerOperation);
+	void checkSegmentOperations(ScriptOperation* segmentOperation);
+	string getOutputFilename(string filename, ImageTracker* imageTracker);
 	/*
 	 * Helper function to get reference image, or else current image
 	 */
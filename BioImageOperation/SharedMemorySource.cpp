@@ -0,0 +1,303 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "SharedMemorySource.h"
+#include "Constants.h"
+#include "Util.h"
+
+static_assert(atomic<uint64_t>::is_always_lock_free, "Shared memory sequence requires lock-free atomic");
+
+
+mutex SharedMemorySource::closedMapsMutex;
+vector<pair<uchar*, size_t>> SharedMemorySource::closedMaps;
+
+
+SharedMemorySource::SharedMemorySource() {
+}
+
+SharedMemorySource::~SharedMemorySource() {
+	close();
+}
+
+void SharedMemorySource::reset() {
+	close();
+	source = "";
+	width = 0;
+	height = 0;
+	type = 0;
+	nslots = 0;
+	readSeq = 0;
+	frameSeq = 0;
+	framei = 0;
+	frameTime = -1;
+	overruns = 0;
+	timeout = 0;
+}
+
+bool SharedMemorySource::init(string basepath, string filepath, int apiCode, string codecs, string start, string length,
+							  double fps, int interval, int total, int width, int height, int prefetch, int dropMode,
+							  bool cache, int colorMode, double timeout) {
+	reset();
+
+	source = filepath;
+	this->timeout = timeout;
+
+	// real-time source: all frames from start of processing
+	calcFrameParams("", length, fps, 1, 0, 0);
+
+	return open();
+}
+
+bool SharedMemorySource::open() {
+	uint64_t written;
+
+#ifdef _WIN32
+	MEMORY_BASIC_INFORMATION info;
+
+	mapHandle = OpenFileMappingA(FILE_MAP_READ | FILE_MAP_COPY, FALSE, source.c_str());
+	if (mapHandle) {
+		// copy-on-write view: in-place changes private to this process
+		mapData = (uchar*)MapViewOfFile(mapHandle, FILE_MAP_COPY, 0, 0, 0);
+		if (mapData && VirtualQuery(mapData, &info, sizeof(info)) > 0) {
+			mapSize = info.RegionSize;
+		}
+		readData = (uchar*)MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0);
+		if (!readData) {
+			mapSize = 0;
+		}
+	}
+#else
+	struct stat info;
+	string name = source;
+
+	if (!Util::startsWith(name, "/")) {
+		name = "/" + name;
+	}
+	mapHandle = shm_open(name.c_str(), O_RDONLY, 0);
+	if (mapHandle >= 0 && fstat(mapHandle, &info) == 0) {
+		mapSize = (size_t)info.st_size;
+		// private (copy-on-write) mapping: in-place changes not visible to writer
+		void* data = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, mapHandle, 0);
+		if (data != MAP_FAILED) {
+			mapData = (uchar*)data;
+		}
+	}
+#endif
+	if (!mapData) {
+		close();
+		throw ios_base::failure("Unable to open shared memory " + source);
+	}
+
+#ifdef _WIN32
+	// headers always read from shared view (copy-on-write view pages can become private)
+	ringHeader = (SharedFrameRingHeader*)readData;
+	slotHeaders = (SharedFrameSlotHeader*)(readData + sizeof(SharedFrameRingHeader));
+#else
+	ringHeader = (SharedFrameRingHeader*)mapData;
+	slotHeaders = (SharedFrameSlotHeader*)(mapData + sizeof(SharedFrameRingHeader));
+#endif
+	if (mapSize < sizeof(SharedFrameRingHeader)
+		|| strncmp(ringHeader->magic, Constants::frameRingMagic.c_str(), sizeof(ringHeader->magic)) != 0
+		|| ringHeader->width <= 0 || ringHeader->height <= 0 || ringHeader->nslots <= 0
+		|| ringHeader->slotSize < (uint64_t)ringHeader->width * ringHeader->height * CV_ELEM_SIZE(ringHeader->type)
+		|| ringHeader->dataOffset < sizeof(SharedFrameRingHeader) + ringHeader->nslots * sizeof(SharedFrameSlotHeader)
+		|| ringHeader->dataOffset + ringHeader->nslots * ringHeader->slotSize > mapSize) {
+		close();
+		throw ios_base::failure("Invalid shared memory frame ring " + source);
+	}
+	width = ringHeader->width;
+	height = ringHeader->height;
+	type = ringHeader->type;
+	nslots = ringHeader->nslots;
+
+	// start at latest frame written
+	written = ringHeader->sequence.load(memory_order_acquire);
+	readSeq = (written > 0) ? written - 1 : 0;
+	return true;
+}
+
+bool SharedMemorySource::getNextImage(Mat* image) {
+	chrono::steady_clock::time_point waitStart = chrono::steady_clock::now();
+	uint64_t written;
+	int sloti = 0;
+
+	if (!mapData || (end > 0 && framei >= end)) {
+		close();
+		return false;
+	}
+
+	if (framei > 0) {
+		releaseFrame();
+	}
+
+	while (true) {
+		written = ringHeader->sequence.load(memory_order_acquire);
+		if (written > readSeq) {
+			if (written - readSeq >= (uint64_t)nslots) {
+				// overrun: frames overwritten before read; continue at latest frame
+				overruns += (int)(written - 1 - readSeq);
+				readSeq = written - 1;
+			}
+			sloti = (int)(readSeq % nslots);
+			if (slotHeaders[sloti].sequence.load(memory_order_acquire) == readSeq) {
+				break;
+			}
+			// slot being overwritten; check again
+			continue;
+		}
+		if (timeout > 0 && chrono::duration<double>(chrono::steady_clock::now() - waitStart).count() >= timeout) {
+			close();
+			return false;
+		}
+		this_thread::sleep_for(chrono::microseconds(pollInterval));
+	}
+
+	// zero-copy: header only, referring to frame slot
+	*image = Mat(height, width, type, mapData + ringHeader->dataOffset + ringHeader->slotSize * sloti);
+	frameTime = slotHeaders[sloti].timestamp;
+	frameSeq = readSeq;
+	frameSloti = sloti;
+#ifdef _WIN32
+	refreshFrame();
+#endif
+	readSeq++;
+	framei++;
+	return true;
+}
+
+void SharedMemorySource::releaseFrame() {
+	uint64_t written = ringHeader->sequence.load(memory_order_acquire);
+
+	// detected after processing: counted with next frame
+	if (written >= frameSeq + nslots || slotHeaders[frameSloti].sequence.load(memory_order_acquire) != frameSeq) {
+		overruns++;
+	}
+
+	// private copies of pages changed by processing no longer follow writer: discard
+#ifdef _WIN32
+	// no discard on Windows: private pages refreshed when slot is read again
+#else
+	uchar* slotData = mapData + ringHeader->dataOffset + ringHeader->slotSize * frameSloti;
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	uchar* start = mapData + (slotData - mapData) / pageSize * pageSize;
+	uchar* end = min(slotData + ringHeader->slotSize, mapData + mapSize);
+
+	madvise(start, end - start, MADV_DONTNEED);
+#endif
+}
+
+#ifdef _WIN32
+void SharedMemorySource::refreshFrame() {
+	uchar* slotData = mapData + ringHeader->dataOffset + ringHeader->slotSize * frameSloti;
+	uchar* slotEnd = slotData + ringHeader->slotSize;
+	uchar* start;
+	uchar* end;
+	MEMORY_BASIC_INFORMATION info;
+
+	for (uchar* page = slotData; page < slotEnd; page = (uchar*)info.BaseAddress + info.RegionSize) {
+		if (VirtualQuery(page, &info, sizeof(info)) == 0) {
+			break;
+		}
+		if (info.Protect == PAGE_READWRITE) {
+			start = max((uchar*)info.BaseAddress, slotData);
+			end = min((uchar*)info.BaseAddress + info.RegionSize, slotEnd);
+			memcpy(start, readData + (start - mapData), end - start);
+		}
+	}
+}
+#endif
+
+void SharedMemorySource::close() {
+	unmap();
+}
+
+void SharedMemorySource::unmap() {
+	if (mapData) {
+		lock_guard<mutex> lock(closedMapsMutex);
+		closedMaps.push_back({ mapData, mapSize });
+	}
+#ifdef _WIN32
+	if (readData) {
+		// not referred to by frames
+		UnmapViewOfFile(readData);
+		readData = nullptr;
+	}
+	if (mapHandle) {
+		CloseHandle(mapHandle);
+		mapHandle = NULL;
+	}
+#else
+	if (mapHandle >= 0) {
+		::close(mapHandle);
+		mapHandle = -1;
+	}
+#endif
+	mapData = nullptr;
+	mapSize = 0;
+	ringHeader = nullptr;
+	slotHeaders = nullptr;
+}
+
+void SharedMemorySource::releaseMaps() {
+	lock_guard<mutex> lock(closedMapsMutex);
+	for (auto& closedMap : closedMaps) {
+#ifdef _WIN32
+		UnmapViewOfFile(closedMap.first);
+#else
+		munmap(closedMap.first, closedMap.second);
+#endif
+	}
+	closedMaps.clear();
+}
+
+int SharedMemorySource::getWidth() {
+	return width;
+}
+
+int SharedMemorySource::getHeight() {
+	return height;
+}
+
+double SharedMemorySource::getFps() {
+	return fps;
+}
+
+int SharedMemorySource::getFrameNumber() {
+	return (int)frameSeq;
+}
+
+string SharedMemorySource::getLabel() {
+	return "";
+}
+
+int SharedMemorySource::getCurrentFrame() {
+	return framei;
+}
+
+int SharedMemorySource::getTotalFrames() {
+	return 0;
+}
+
+double SharedMemorySource::getFrameTime() {
+	return frameTime;
+}
+
+int SharedMemorySource::getDroppedFrames() {
+	return overruns;
+}
@@ -0,0 +1,128 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "FrameSource.h"
+
+using namespace std;
+using namespace cv;
+
+
+/*
+ * Shared memory ring buffer layout, as written by acquisition process:
+ * ring header, followed by slot headers, followed (at dataOffset) by frame slots of slotSize bytes.
+ * Writer writes frame i into slot i % nslots, then sets the slot sequence to i, then sets the ring sequence to i + 1
+ */
+
+struct SharedFrameRingHeader
+{
+	char magic[16];					// Constants::frameRingMagic
+	int32_t width;
+	int32_t height;
+	int32_t type;					// OpenCV Mat type
+	int32_t nslots;
+	uint64_t slotSize;				// bytes per frame slot
+	uint64_t dataOffset;			// offset of first frame slot
+	atomic<uint64_t> sequence;		// number of frames written
+};
+
+struct SharedFrameSlotHeader
+{
+	atomic<uint64_t> sequence;		// frame written in slot
+	double timestamp;				// [s]
+};
+
+
+/*
+ * Source for frames in shared memory ring buffer of co-located acquisition process.
+ * Frames are not copied: image refers to ring slot directly, until overwritten by writer (overrun).
+ * Ring mapped copy-on-write: changes by processing are not written back to the acquisition process
+ */
+
+class SharedMemorySource : public FrameSource
+{
+public:
+	static constexpr int pollInterval = 100;	// [us]
+
+	string source;
+	int width = 0;
+	int height = 0;
+	int type = 0;
+	int nslots = 0;
+	uint64_t readSeq = 0;			// next frame to read
+	uint64_t frameSeq = 0;			// current frame
+	int frameSloti = 0;				// slot of current frame
+	int framei = 0;
+	double frameTime = -1;
+	int overruns = 0;				// frames overwritten before or while being processed
+	double timeout = 0;
+
+	SharedMemorySource();
+	~SharedMemorySource();
+	void reset();
+	bool init(string basepath, string filepath, int apiCode, string codecs = "", string start = "", string length = "",
+			  double fps = 1, int interval = 1, int total = 0, int width = 0, int height = 0, int prefetch = 0, int dropMode = 0,
+			  bool cache = false, int colorMode = -1, double timeout = 0);
+	bool open();
+	bool getNextImage(Mat* image);
+	void close();
+
+	int getWidth();
+	int getHeight();
+	double getFps();
+	int getFrameNumber();
+
+	string getLabel();
+	int getCurrentFrame();
+	int getTotalFrames();
+	double getFrameTime();
+	int getDroppedFrames();
+
+	/*
+	 * Unmap closed rings; frames (Mat headers) can be referenced until processing is reset
+	 */
+	static void releaseMaps();
+
+private:
+	static mutex closedMapsMutex;
+	static vector<pair<uchar*, size_t>> closedMaps;
+
+	uchar* mapData = nullptr;
+	size_t mapSize = 0;
+	SharedFrameRingHeader* ringHeader = nullptr;
+	SharedFrameSlotHeader* slotHeaders = nullptr;
+#ifdef _WIN32
+	HANDLE mapHandle = NULL;
+	uchar* readData = nullptr;		// shared read-only view: ring and slot headers, source of changed frame pages
+#else
+	int mapHandle = -1;
+#endif
+
+	void unmap();
+
+	/*
+	 * Check if current frame was overwritten while processed, and discard changes made to its slot
+	 */
+	void releaseFrame();
+
+#ifdef _WIN32
+	/*
+	 * Copy pages of current frame changed by processing (private) from shared view; other pages follow writer
+	 */
+	void refreshFrame();
+#endif
+};
@@ -0,0 +1,224 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include <algorithm>
+#include "StackSource.h"
+#include "Util.h"
+
+
+StackSource::StackSource() {
+}
+
+StackSource::~StackSource() {
+	close();
+}
+
+void StackSource::reset() {
+	close();
+	sourcePath.reset();
+	filenames.clear();
+	fileStarts.clear();
+	npages = 0;
+	pagei = 0;
+	start = 0;
+	end = 0;
+	interval = 1;
+	width = 0;
+	height = 0;
+	prefetch = 0;
+	outputPagei = 0;
+	outputLabel = "";
+}
+
+bool StackSource::init(string basepath, string filepath, int apiCode, string codecs, string start, string length,
+					   double fps0, int interval, int total, int width, int height, int prefetch, int dropMode,
+					   bool cache, int colorMode, double timeout) {
+	string filename;
+	int nfiles, n;
+
+	reset();
+
+	sourcePath.setInputPath(basepath, filepath);
+
+	nfiles = sourcePath.getFileCount();
+	if (nfiles == 0) {
+		throw ios_base::failure("File(s) not found: " + sourcePath.templatePath);
+	}
+
+	// index pages of all files
+	for (int filei = 0; filei < nfiles; filei++) {
+		filename = sourcePath.createFilePath(filei);
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+		n = (int)imcount(filename, ImreadModes::IMREAD_UNCHANGED);
+#else
+		// no page count without loading: keep pages of last file loaded
+		pages.clear();
+		n = 0;
+		if (imreadmulti(filename, pages, ImreadModes::IMREAD_UNCHANGED)) {
+			n = (int)pages.size();
+			pagesFilei = filei;
+		}
+#endif
+		if (n <= 0) {
+			throw ios_base::failure("Image stack load error " + filename);
+		}
+		filenames.push_back(filename);
+		fileStarts.push_back(npages);
+		npages += n;
+	}
+
+	calcFrameParams(start, length, fps0, interval, total, npages);
+
+	pagei = this->start;
+	outputPagei = pagei;
+
+	this->prefetch = prefetch;
+	if (prefetch > 0) {
+		startDecodeThread();
+	}
+	return true;
+}
+
+void StackSource::close() {
+	stopDecodeThread();
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+	pages = ImageCollection();
+#else
+	pages.clear();
+#endif
+	pagesFilei = -1;
+}
+
+bool StackSource::getNextImage(Mat* image) {
+	FrameItem item;
+	bool frameOk = false;
+
+	if (decodeThread) {
+		frameOk = frameQueue.pop(item);
+		if (frameOk) {
+			*image = item.image;
+			outputPagei = item.framei;
+			outputLabel = item.label;
+		} else {
+			// pass on any error from decode thread
+			frameQueue.checkError();
+		}
+	} else {
+		frameOk = readNextImage(image, &outputPagei, &outputLabel);
+	}
+
+	if (frameOk) {
+		width = image->cols;
+		height = image->rows;
+		outputPagei += interval;
+	} else {
+		close();
+	}
+	return frameOk;
+}
+
+bool StackSource::readNextImage(Mat* image, int* framei, string* label) {
+	if (pagei >= end) {
+		return false;
+	}
+	readPage(pagei, image, label);
+	*framei = pagei;
+	pagei += interval;
+	return true;
+}
+
+void StackSource::readPage(int pagei, Mat* image, string* label) {
+	int filei = (int)(upper_bound(fileStarts.begin(), fileStarts.end(), pagei) - fileStarts.begin()) - 1;
+	int filePagei = pagei - fileStarts[filei];
+
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+	if (filei != pagesFilei) {
+		pages = ImageCollection(filenames[filei], ImreadModes::IMREAD_UNCHANGED);
+		pagesFilei = filei;
+	}
+	// collection advances page by page from last position; only decodes requested page
+	*image = pages.at(filePagei);
+	pages.releaseCache(filePagei);
+#else
+	if (filei != pagesFilei) {
+		pages.clear();
+		if (!imreadmulti(filenames[filei], pages, ImreadModes::IMREAD_UNCHANGED)) {
+			pages.clear();
+		}
+		pagesFilei = filei;
+	}
+	*image = Mat();
+	if (filePagei < (int)pages.size()) {
+		*image = pages[filePagei];
+	}
+#endif
+	if (!Util::isValidImage(image)) {
+		throw ios_base::failure("Image load error " + filenames[filei] + " page " + to_string(filePagei));
+	}
+	*label = Util::extractFileTitle(filenames[filei]);
+}
+
+void StackSource::startDecodeThread() {
+	frameQueue.reset(prefetch);
+	decodeThread = new std::thread(&StackSource::decodeThreadMethod, this);
+}
+
+void StackSource::stopDecodeThread() {
+	if (decodeThread) {
+		frameQueue.abort();
+		decodeThread->join();
+		delete decodeThread;
+		decodeThread = nullptr;
+	}
+}
+
+void StackSource::decodeThreadMethod() {
+	FrameItem item;
+	bool frameOk = true;
+
+	try {
+		while (frameOk) {
+			frameOk = readNextImage(&item.image, &item.framei, &item.label);
+			if (frameOk) {
+				frameOk = frameQueue.push(item);
+			}
+		}
+		frameQueue.finish();
+	} catch (...) {
+		frameQueue.finish(current_exception());
+	}
+}
+
+int StackSource::getWidth() {
+	return width;
+}
+
+int StackSource::getHeight() {
+	return height;
+}
+
+double StackSource::getFps() {
+	return 0;
+}
+
+int StackSource::getFrameNumber() {
+	return outputPagei;
+}
+
+string StackSource::getLabel() {
+	return outputLabel;
+}
+
+int StackSource::getCurrentFrame() {
+	return outputPagei - start;
+}
+
+int StackSource::getTotalFrames() {
+	return end - start;
+}
@@ -0,0 +1,76 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <thread>
+#include <opencv2/opencv.hpp>
+#include "FrameSource.h"
+#include "FrameQueue.h"
+#include "NumericPath.h"
+
+using namespace std;
+using namespace cv;
+
+
+/*
+ * Source for multi-page image stack file(s) (TIFF); pages of all files are indexed once and decoded on demand
+ * (OpenCV before 4.6: all pages of current file loaded at once)
+ */
+
+class StackSource : public FrameSource
+{
+public:
+	NumericPath sourcePath;
+	vector<string> filenames;
+	vector<int> fileStarts;		// first (global) page of each file
+	int npages = 0;
+	int pagei = 0;
+	int width = 0;
+	int height = 0;
+
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+	ImageCollection pages;
+#else
+	vector<Mat> pages;
+#endif
+	int pagesFilei = -1;
+
+	int prefetch = 0;
+	std::thread* decodeThread = nullptr;
+	FrameQueue frameQueue;
+	int outputPagei = 0;
+	string outputLabel = "";
+
+	StackSource();
+	~StackSource();
+	void reset();
+	bool init(string basepath, string filepath, int apiCode, string codecs = "", string start = "", string length = "",
+			  double fps = 1, int interval = 1, int total = 0, int width = 0, int height = 0, int prefetch = 0, int dropMode = 0,
+			  bool cache = false, int colorMode = -1, double timeout = 0);
+	void close();
+	bool getNextImage(Mat* image);
+	bool readNextImage(Mat* image, int* framei, string* label);
+	void readPage(int pagei, Mat* image, string* label);
+
+	/*
+	 * Prefetch mode: decode pages in separate thread ahead of processing
+	 */
+	void startDecodeThread();
+	void stopDecodeThread();
+	void decodeThreadMethod();
+
+	int getWidth();
+	int getHeight();
+	double getFps();
+	int getFrameNumber();
+
+	string getLabel();
+	int getCurrentFrame();
+	int getTotalFrames();
+};
@@ -227,11 +227,10 @@ ParamRange StatData::getParamRange() {
 
 void StatData::saveData(string filename) {
 	OutputStream outStream(filename);
-	string s = "";
 
 	for (double x : data) {
-		s += Util::format("%f\n", x);
+		outStream.addValue(x);
+		outStream.endRow();
 	}
-
-	outStream.write(s);
+	outStream.closeStream();
 }
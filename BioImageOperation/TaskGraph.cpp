@@ -0,0 +1,139 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include <algorithm>
+#include "TaskGraph.h"
+
+
+TaskGraph::TaskGraph() {
+}
+
+TaskGraph::~TaskGraph() {
+	stop();
+}
+
+void TaskGraph::start(int ntasks, function<void(int)> taskMethod, int nthreads) {
+	stop();
+	this->ntasks = ntasks;
+	this->taskMethod = taskMethod;
+	dependents.assign(ntasks, vector<int>());
+	ndependencies.assign(ntasks, 0);
+
+	for (int threadi = 1; threadi < nthreads; threadi++) {
+		threads.push_back(new std::thread(&TaskGraph::workerThreadMethod, this));
+	}
+}
+
+void TaskGraph::addDependency(int task, int dependency) {
+	if (dependency < 0 || dependency >= task
+		|| find(dependents[dependency].begin(), dependents[dependency].end(), task) != dependents[dependency].end()) {
+		return;
+	}
+	dependents[dependency].push_back(task);
+	ndependencies[task]++;
+}
+
+void TaskGraph::run() {
+	unique_lock<mutex> lock(graphMutex);
+	exception_ptr error0;
+
+	waiting = ndependencies;
+	ready.clear();
+	ndone = 0;
+	error = nullptr;
+	for (int task = 0; task < ntasks; task++) {
+		if (waiting[task] == 0) {
+			ready.insert(task);
+		}
+	}
+	changed.notify_all();
+
+	while (!isRunDone()) {
+		if (!ready.empty()) {
+			processTask(lock);
+		} else {
+			changed.wait(lock);
+		}
+	}
+
+	error0 = error;
+	error = nullptr;
+	lock.unlock();
+	if (error0) {
+		rethrow_exception(error0);
+	}
+}
+
+void TaskGraph::stop() {
+	{
+		lock_guard<mutex> lock(graphMutex);
+		stopping = true;
+	}
+	changed.notify_all();
+
+	for (std::thread* thread : threads) {
+		thread->join();
+		delete thread;
+	}
+	threads.clear();
+	stopping = false;
+}
+
+int TaskGraph::getThreadCount() {
+	return (int)threads.size() + 1;
+}
+
+void TaskGraph::workerThreadMethod() {
+	unique_lock<mutex> lock(graphMutex);
+
+	while (true) {
+		changed.wait(lock, [this] { return stopping || !ready.empty(); });
+		if (stopping) {
+			break;
+		}
+		processTask(lock);
+	}
+}
+
+void TaskGraph::processTask(unique_lock<mutex>& lock) {
+	exception_ptr taskError = nullptr;
+	int task = *ready.begin();
+
+	ready.erase(ready.begin());
+	nactive++;
+	lock.unlock();
+
+	try {
+		taskMethod(task);
+	} catch (...) {
+		taskError = current_exception();
+	}
+
+	lock.lock();
+	nactive--;
+	ndone++;
+	if (taskError) {
+		if (!error) {
+			error = taskError;
+		}
+		// remaining tasks not started
+		ready.clear();
+	} else if (!error) {
+		for (int dependent : dependents[task]) {
+			if (--waiting[dependent] == 0) {
+				ready.insert(dependent);
+			}
+		}
+	}
+	changed.notify_all();
+}
+
+bool TaskGraph::isRunDone() {
+	return (ndone == ntasks || error) && nactive == 0;
+}
@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <vector>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+using namespace std;
+
+
+/*
+ * Graph of tasks with dependencies, processed repeatedly by worker threads: task started as soon as tasks it depends on are done
+ */
+
+class TaskGraph
+{
+public:
+	TaskGraph();
+	~TaskGraph();
+
+	/*
+	 * Start worker threads; calling thread of run() processes tasks as well
+	 */
+	void start(int ntasks, function<void(int)> taskMethod, int nthreads);
+
+	/*
+	 * Task only started after dependency (lower task index) is done
+	 */
+	void addDependency(int task, int dependency);
+
+	/*
+	 * Process all tasks once, ready tasks in order of index. Blocks until done. Passes on error of any task
+	 */
+	void run();
+	void stop();
+	int getThreadCount();
+
+private:
+	function<void(int)> taskMethod;
+	vector<vector<int>> dependents;
+	vector<int> ndependencies;
+	vector<int> waiting;			// dependencies not done yet (current run)
+	set<int> ready;
+	int ntasks = 0;
+	int ndone = 0;
+	int nactive = 0;
+	bool stopping = false;
+	vector<std::thread*> threads;
+	mutex graphMutex;
+	condition_variable changed;
+	exception_ptr error = nullptr;
+
+	void workerThreadMethod();
+
+	/*
+	 * Process first ready task, releasing tasks depending on it (lock held before and after)
+	 */
+	void processTask(unique_lock<mutex>& lock);
+	bool isRunDone();
+};
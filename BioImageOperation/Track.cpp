@@ -331,21 +331,19 @@ void Track::drawLabel(Mat* image, Scalar color, int drawMode) {
 	}
 }
 
-string Track::getCsvHeader(bool outputContour) {
+string Track::getCsvHeader(bool outputContour, ContourFormat contourFormat) {
 	string header = "track_label,cluster_label,is_merged"
 					",x,y,v,projection,v_projection,a"
 					",dist,dist_tot,dist_origin"
 					",angle,v_angle,a_angle"
 					",area,area1,length_major,length_major1,length_minor,length_minor1,rad";
 	if (outputContour) {
-		header += ",contour";
+		header += (contourFormat == ContourFormat::ChainCode) ? ",contour_chain" : ",contour";
 	}
 	return header;
 }
 
-string Track::getCsv(bool outputContour, Cluster* cluster) {
-	string csv;
-	vector<Point> contour;
+void Track::getValues(double* values) {
 	Point2d* point;
 	Point2d* lastPoint = nullptr;
 	double dist, dx, dy, dx1, dy1, lastDist, ddist, proj, centDist;
@@ -361,12 +359,6 @@ string Track::getCsv(bool outputContour, Cluster* cluster) {
 	int ii = 0;
 	int n = (int)(round(fps * windowSize));
 
-	csv = format("%d,", label);
-	if (clusterLabel >= 0) {
-		csv += to_string(clusterLabel);
-	}
-	csv += format(",%s", isMerged ? "true" : "false");
-
 	for (int i = points.size() - 1; i >= 0; i--) {
 		// reverse order loop: inverse delta subtractions
 		point = &points[i];
@@ -423,29 +415,41 @@ string Track::getCsv(bool outputContour, Cluster* cluster) {
 
 	centDist = Util::calcDistance(originX, originY, x, y);
 
-	csv += format(",%f,%f,%f,%f,%f,%f", x * pixelSize, y * pixelSize, v * pixelSize * fps, projection, vProjection * pixelSize * fps, a * pixelSize * fps * fps);
-	csv += format(",%f,%f,%f", this->dist * pixelSize, totdist * pixelSize, centDist * pixelSize);
-	csv += format(",%f,%f,%f", orientation, v_angle * fps, a_angle * fps * fps);
-	csv += format(",%f,%f,%f,%f,%f,%f,%f",
-					area * pixelSize * pixelSize, meanArea * pixelSize * pixelSize,
-					lengthMajor * pixelSize, meanLengthMajor * pixelSize,
-					lengthMinor * pixelSize, meanLengthMinor * pixelSize,
-					rad * pixelSize);
+	double trackValues[nvalues] = {
+		x * pixelSize, y * pixelSize, v * pixelSize * fps, projection, vProjection * pixelSize * fps, a * pixelSize * fps * fps,
+		this->dist * pixelSize, totdist * pixelSize, centDist * pixelSize,
+		orientation, v_angle * fps, a_angle * fps * fps,
+		area * pixelSize * pixelSize, meanArea * pixelSize * pixelSize,
+		lengthMajor * pixelSize, meanLengthMajor * pixelSize,
+		lengthMinor * pixelSize, meanLengthMinor * pixelSize,
+		rad * pixelSize
+	};
+	copy(trackValues, trackValues + nvalues, values);
+}
+
+void Track::writeCsv(OutputStream* stream, bool outputContour, Cluster* cluster, ContourFormat contourFormat) {
+	double values[nvalues];
+
+	stream->addValue(label);
+	if (clusterLabel >= 0) {
+		stream->addValue(clusterLabel);
+	} else {
+		stream->addEmpty();
+	}
+	stream->addValue(isMerged);
+
+	getValues(values);
+	for (double value : values) {
+		stream->addValue(value);
+	}
 
 	if (outputContour) {
-		csv += ",";
 		if (cluster && cluster->hasSingleTrack()) {
-			contour = cluster->getContour();
-			for (Point point : contour) {
-				if (pixelSize == 1) {
-					csv += Util::format("%d %d ", point.x, point.y);
-				} else {
-					csv += Util::format("%f %f ", point.x * pixelSize, point.y * pixelSize);
-				}
-			}
+			cluster->writeContour(stream, contourFormat);
+		} else {
+			stream->addEmpty();
 		}
 	}
-	return csv;
 }
 
 string Track::toString() {
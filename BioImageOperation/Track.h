@@ -11,6 +11,7 @@
 #include <opencv2/opencv.hpp>
 #include "Cluster.h"
 #include "Constants.h"
+#include "OutputStream.h"
 
 using namespace cv;
 
@@ -27,6 +28,8 @@ class PathNode;		// forward declaration
 class Track
 {
 public:
+	static const int nvalues = 19;
+
 	int label = -1;
 	int clusterLabel = -1;
 
@@ -93,7 +96,12 @@ public:
 	void drawAngle(Mat* image, Scalar color);
 	void drawTracks(Mat* image, Scalar color, int ntracks = 1);
 	void drawLabel(Mat* image, Scalar color, int drawMode);
-	static string getCsvHeader(bool outputContour = false);
-	string getCsv(bool outputContour = false, Cluster* cluster = nullptr);
+	static string getCsvHeader(bool outputContour = false, ContourFormat contourFormat = ContourFormat::Points);
+	void writeCsv(OutputStream* stream, bool outputContour = false, Cluster* cluster = nullptr, ContourFormat contourFormat = ContourFormat::Points);
+
+	/*
+	 * Numeric (float) values, in order of header columns from x
+	 */
+	void getValues(double* values);
 	string toString();
 };
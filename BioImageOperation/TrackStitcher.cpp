@@ -0,0 +1,182 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <set>
+#include "TrackStitcher.h"
+#include "OutputStream.h"
+#include "Util.h"
+
+
+StitchRow::StitchRow(string line) {
+	values = Util::split(line, ",");
+	if (values.size() > TrackStitcher::yColumn) {
+		frame = stoi(values[TrackStitcher::frameColumn]);
+		x = Util::toDouble(values[TrackStitcher::xColumn]);
+		y = Util::toDouble(values[TrackStitcher::yColumn]);
+		for (string label : Util::split(values[TrackStitcher::labelColumn], " ", true)) {
+			if (label != "") {
+				labels.push_back(stoi(label));
+			}
+		}
+	}
+}
+
+string StitchRow::getCsv() {
+	string csv, label;
+
+	for (int labeli = 0; labeli < labels.size(); labeli++) {
+		if (labeli > 0) {
+			label += " ";
+		}
+		label += to_string(labels[labeli]);
+	}
+	if (values.size() > TrackStitcher::labelColumn) {
+		values[TrackStitcher::labelColumn] = label;
+	}
+
+	for (int i = 0; i < values.size(); i++) {
+		if (i > 0) {
+			csv += ",";
+		}
+		csv += values[i];
+	}
+	return csv;
+}
+
+void TrackStitcher::stitch(string filename, vector<int> segmentStarts, int overlap, double maxDistance) {
+	OutputStream output;
+	ifstream input;
+	string partFilename, line;
+	map<int, vector<StitchRow>> rows, prevRows, nextPrevRows;
+	map<int, int> labelMap;
+	int nsegments = (int)segmentStarts.size() - 1;
+	int maxLabel = -1;
+	bool matched;
+	bool outputInit = false;
+
+	for (int segmenti = 0; segmenti < nsegments; segmenti++) {
+		partFilename = getPartFilename(filename, segmenti);
+		if (!filesystem::exists(partFilename)) {
+			prevRows.clear();
+			continue;
+		}
+
+		input.open(partFilename);
+		if (!input.is_open()) {
+			throw ios_base::failure("Unable to read file " + partFilename + "\n" + Util::getErr());
+		}
+		// header
+		getline(input, line);
+		if (!outputInit) {
+			// parts uncompressed; output compressed as any output stream for .gz / .zst extension
+			output.init(filename, line + "\n");
+			outputInit = true;
+		}
+
+		rows.clear();
+		nextPrevRows.clear();
+		labelMap.clear();
+		matched = (segmenti == 0);
+
+		while (getline(input, line)) {
+			if (line == "") {
+				continue;
+			}
+			StitchRow row(line);
+			if (!matched) {
+				if (row.frame < segmentStarts[segmenti]) {
+					// overlap with previous segment: only used for matching
+					rows[row.frame].push_back(row);
+					continue;
+				}
+				labelMap = matchLabels(rows, prevRows, maxDistance);
+				matched = true;
+			}
+
+			for (int& label : row.labels) {
+				if (labelMap.find(label) == labelMap.end()) {
+					if (segmenti == 0) {
+						labelMap[label] = label;
+					} else {
+						labelMap[label] = ++maxLabel;
+					}
+				}
+				label = labelMap[label];
+				maxLabel = max(label, maxLabel);
+			}
+			output.write(row.getCsv() + "\n");
+
+			if (segmenti + 1 < nsegments && row.frame >= segmentStarts[segmenti + 1] - overlap) {
+				nextPrevRows[row.frame].push_back(row);
+			}
+		}
+
+		input.close();
+		filesystem::remove(partFilename);
+		prevRows = nextPrevRows;
+	}
+
+	output.closeStream();
+}
+
+map<int, int> TrackStitcher::matchLabels(map<int, vector<StitchRow>>& rows, map<int, vector<StitchRow>>& prevRows, double maxDistance) {
+	map<pair<int, int>, int> votes;
+	vector<pair<int, pair<int, int>>> sortedVotes;
+	map<int, int> labelMap;
+	set<int> usedLabels;
+	StitchRow* nearestRow;
+	double dist, minDist;
+
+	// vote label pairs of nearest (single labelled) rows in same frame, within max distance
+	for (auto& frameRows : rows) {
+		auto prevFrameRows = prevRows.find(frameRows.first);
+		if (prevFrameRows == prevRows.end()) {
+			continue;
+		}
+		for (StitchRow& row : frameRows.second) {
+			if (row.labels.size() != 1) {
+				continue;
+			}
+			nearestRow = nullptr;
+			minDist = 0;
+			for (StitchRow& prevRow : prevFrameRows->second) {
+				if (prevRow.labels.size() == 1) {
+					dist = Util::calcDistance(row.x, row.y, prevRow.x, prevRow.y);
+					if (!nearestRow || dist < minDist) {
+						nearestRow = &prevRow;
+						minDist = dist;
+					}
+				}
+			}
+			if (nearestRow && (maxDistance <= 0 || minDist <= maxDistance)) {
+				votes[{ row.labels[0], nearestRow->labels[0] }]++;
+			}
+		}
+	}
+
+	// assign one to one, most votes first
+	for (auto& vote : votes) {
+		sortedVotes.push_back({ vote.second, vote.first });
+	}
+	sort(sortedVotes.rbegin(), sortedVotes.rend());
+	for (auto& vote : sortedVotes) {
+		if (labelMap.find(vote.second.first) == labelMap.end() && usedLabels.find(vote.second.second) == usedLabels.end()) {
+			labelMap[vote.second.first] = vote.second.second;
+			usedLabels.insert(vote.second.second);
+		}
+	}
+	return labelMap;
+}
+
+string TrackStitcher::getPartFilename(string filename, int segmenti) {
+	return filename + ".part" + to_string(segmenti);
+}
@@ -0,0 +1,58 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+
+/*
+ * Data row of cluster/track (by time) CSV output
+ */
+
+class StitchRow
+{
+public:
+	vector<string> values;
+	vector<int> labels;
+	int frame = 0;
+	double x = 0;
+	double y = 0;
+
+	StitchRow(string line);
+	string getCsv();
+};
+
+
+/*
+ * Merges cluster/track output of video segments processed in parallel into single file,
+ * relabelling tracks by matching them in the overlap between consecutive segments
+ */
+
+class TrackStitcher
+{
+public:
+	static const int frameColumn = 0;
+	static const int labelColumn = 2;
+	static const int xColumn = 5;
+	static const int yColumn = 6;
+
+	/*
+	 * Segment i covers frames segmentStarts[i] ... segmentStarts[i + 1] - 1, preceded by overlap frames.
+	 * Tracks only matched within max distance (0: unlimited); unmatched tracks get new labels
+	 */
+	static void stitch(string filename, vector<int> segmentStarts, int overlap, double maxDistance = 0);
+	static string getPartFilename(string filename, int segmenti);
+
+private:
+	static map<int, int> matchLabels(map<int, vector<StitchRow>>& rows, map<int, vector<StitchRow>>& prevRows, double maxDistance);
+};
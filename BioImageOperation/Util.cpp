@@ -587,14 +587,7 @@ vector<string> Util::getImageFilenames(string searchpath) {
 	vector<string> filenames;
 	string filename;
     string path = extractFilePath(searchpath);
-    string pattern = extractFileName(searchpath);
-	regex rx;
-
-	// very basic * ? pattern matching using regex
-	pattern = replace(pattern, ".", "\\.");
-	pattern = replace(pattern, "?", ".");
-	pattern = replace(pattern, "*", ".*");
-    rx = regex(pattern);
+    regex rx = createFilePatternRegex(extractFileName(searchpath));
 
     for (const auto& entry : filesystem::directory_iterator(path)) {
         filename = entry.path().string();
@@ -606,6 +599,14 @@ vector<string> Util::getImageFilenames(string searchpath) {
 	return filenames;
 }
 
+regex Util::createFilePatternRegex(string pattern) {
+	// very basic * ? pattern matching using regex
+	pattern = replace(pattern, ".", "\\.");
+	pattern = replace(pattern, "?", ".");
+	pattern = replace(pattern, "*", ".*");
+	return regex(pattern);
+}
+
 string Util::extractFilePath(string filepath) {
     return filesystem::path(filepath).parent_path().string();
 }
@@ -10,6 +10,7 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <regex>
 #ifndef _CONSOLE
 #include <QObject>
 #include <QImage>
@@ -88,6 +89,7 @@ public:
 	static string getCodecString(int codec);
 
     static vector<string> getImageFilenames(string searchpath);
+    static regex createFilePatternRegex(string pattern);
     static string extractFilePath(string filepath);
     static string extractFileTitle(string filepath);
     static string extractFileName(string filepath);
@@ -0,0 +1,129 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+#include "VideoIndex.h"
+#include "Constants.h"
+#include "Util.h"
+
+using namespace cv;
+
+
+VideoIndex::VideoIndex() {
+}
+
+void VideoIndex::reset() {
+	keyFrames.clear();
+	set = false;
+}
+
+bool VideoIndex::init(string filename) {
+	string indexFilename = getIndexFilename(filename);
+	string header = getFileHeader(filename);
+
+	reset();
+
+	if (!load(indexFilename, header)) {
+		if (create(filename)) {
+			save(indexFilename, header);
+		}
+	}
+	return set;
+}
+
+bool VideoIndex::load(string indexFilename, string header) {
+	vector<string> lines;
+
+	if (!filesystem::exists(indexFilename)) {
+		return false;
+	}
+	try {
+		lines = Util::split(Util::readText(indexFilename), "\n", true);
+	} catch (exception&) {
+		return false;
+	}
+	if (lines.empty() || Util::trim(lines[0]) != header) {
+		// video file changed
+		return false;
+	}
+
+	for (int linei = 1; linei < lines.size(); linei++) {
+		if (Util::isNumeric(lines[linei])) {
+			keyFrames.push_back(stoi(lines[linei]));
+		}
+	}
+	set = !keyFrames.empty();
+	return set;
+}
+
+bool VideoIndex::create(string filename) {
+	// read raw (encoded) stream without decoding to find key frames
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+	VideoCapture videoCapture;
+	int framei = 0;
+
+	if (videoCapture.open(filename, VideoCaptureAPIs::CAP_FFMPEG, { VideoCaptureProperties::CAP_PROP_FORMAT, -1 })) {
+		while (videoCapture.grab()) {
+			if (videoCapture.get(VideoCaptureProperties::CAP_PROP_LRF_HAS_KEY_FRAME) != 0) {
+				keyFrames.push_back(framei);
+			}
+			framei++;
+		}
+		videoCapture.release();
+	}
+#endif
+	set = !keyFrames.empty();
+	return set;
+}
+
+void VideoIndex::save(string indexFilename, string header) {
+	ofstream output;
+
+	try {
+		output.open(indexFilename);
+		if (output.is_open()) {
+			output << header << "\n";
+			for (int keyFrame : keyFrames) {
+				output << keyFrame << "\n";
+			}
+			output.close();
+		}
+	} catch (exception&) {
+		// optional cache; ignore if not writable
+	}
+}
+
+int VideoIndex::getKeyFrame(int frame) {
+	auto item = upper_bound(keyFrames.begin(), keyFrames.end(), frame);
+	if (item == keyFrames.begin()) {
+		return 0;
+	}
+	return *(item - 1);
+}
+
+bool VideoIndex::isSet() {
+	return set;
+}
+
+string VideoIndex::getIndexFilename(string filename) {
+	return filename + "." + Constants::videoIndexExtension;
+}
+
+string VideoIndex::getFileHeader(string filename) {
+	string header;
+	try {
+		header = to_string(filesystem::file_size(filename)) + ","
+				+ to_string(filesystem::last_write_time(filename).time_since_epoch().count());
+	} catch (exception&) {
+	}
+	return header;
+}
@@ -0,0 +1,47 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+/*
+ * Key frame index of video file, cached in sidecar file next to the video.
+ * Frames numbered in packet order (FFmpeg): only valid with FFmpeg backend, and if matching position after seeking
+ */
+
+class VideoIndex
+{
+public:
+	vector<int> keyFrames;
+	bool set = false;
+
+	VideoIndex();
+	void reset();
+
+	/*
+	 * Load index from sidecar file if up to date, otherwise create and save
+	 */
+	bool init(string filename);
+	bool load(string indexFilename, string header);
+	bool create(string filename);
+	void save(string indexFilename, string header);
+
+	/*
+	 * Nearest key frame at or before frame
+	 */
+	int getKeyFrame(int frame);
+	bool isSet();
+
+	static string getIndexFilename(string filename);
+	static string getFileHeader(string filename);
+};
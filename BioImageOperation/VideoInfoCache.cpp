@@ -0,0 +1,191 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <opencv2/opencv.hpp>
+#include "VideoInfoCache.h"
+#include "VideoIndex.h"
+#include "Constants.h"
+#include "Util.h"
+
+using namespace cv;
+
+
+VideoInfoCache::VideoInfoCache() {
+}
+
+void VideoInfoCache::load(string cacheFilename) {
+	VideoInfo videoInfo;
+	vector<string> lines, parts;
+	size_t pos;
+
+	videoInfos.clear();
+	changed = false;
+
+	if (!filesystem::exists(cacheFilename)) {
+		return;
+	}
+	try {
+		lines = Util::split(Util::readText(cacheFilename), "\n", true);
+	} catch (exception&) {
+		return;
+	}
+
+	// skip header line
+	for (int linei = 1; linei < lines.size(); linei++) {
+		parts = Util::split(lines[linei], ",");
+		if (parts.size() >= 7) {
+			try {
+				videoInfo.header = parts[0] + "," + parts[1];
+				videoInfo.nframes = stoi(parts[2]);
+				videoInfo.width = stoi(parts[3]);
+				videoInfo.height = stoi(parts[4]);
+				videoInfo.fps = Util::toDouble(parts[5]);
+				// file name last; can contain separator
+				pos = 0;
+				for (int parti = 0; parti < 6; parti++) {
+					pos = lines[linei].find(",", pos) + 1;
+				}
+				videoInfos[lines[linei].substr(pos)] = videoInfo;
+			} catch (exception&) {
+			}
+		}
+	}
+}
+
+void VideoInfoCache::save(string cacheFilename) {
+	ofstream output;
+	stringstream tempId;
+	string tempFilename;
+	error_code error;
+
+	if (!changed) {
+		return;
+	}
+
+	// write to own temporary file, then replace: cache file can be read and saved concurrently
+	tempId << this_thread::get_id();
+	tempFilename = cacheFilename + "." + tempId.str() + ".tmp";
+	try {
+		output.open(tempFilename, ios_base::trunc);
+		if (output.is_open()) {
+			output << "size,time,frames,width,height,fps,filename\n";
+			for (auto item : videoInfos) {
+				output << item.second.header << "," << item.second.nframes << "," << item.second.width << "," << item.second.height << ","
+						<< Util::format("%f", item.second.fps) << "," << item.first << "\n";
+			}
+			output.close();
+			if (output.fail()) {
+				filesystem::remove(tempFilename, error);
+			} else {
+				filesystem::rename(tempFilename, cacheFilename);
+			}
+		}
+	} catch (exception&) {
+		// optional cache; ignore if not writable
+		filesystem::remove(tempFilename, error);
+	}
+	changed = false;
+}
+
+vector<VideoInfo> VideoInfoCache::getVideoInfos(vector<string> filenames, int apiCode) {
+	vector<VideoInfo> fileVideoInfos(filenames.size());
+	vector<exception_ptr> errors(filenames.size());
+	vector<int> readIndices;
+	vector<std::thread> threads;
+	atomic<int> nexti(0);
+	string cacheFilename, title, header;
+	int nthreads;
+
+	if (filenames.empty()) {
+		return fileVideoInfos;
+	}
+
+	cacheFilename = getCacheFilename(filenames[0]);
+	load(cacheFilename);
+
+	for (int filei = 0; filei < filenames.size(); filei++) {
+		title = Util::extractFileName(filenames[filei]);
+		header = VideoIndex::getFileHeader(filenames[filei]);
+		auto item = videoInfos.find(title);
+		if (item != videoInfos.end() && item->second.header == header) {
+			fileVideoInfos[filei] = item->second;
+		} else {
+			readIndices.push_back(filei);
+		}
+	}
+
+	if (!readIndices.empty()) {
+		nthreads = min((int)std::thread::hardware_concurrency(), (int)readIndices.size());
+		if (nthreads < 1) {
+			nthreads = 1;
+		}
+		for (int threadi = 0; threadi < nthreads; threadi++) {
+			threads.push_back(std::thread([&] {
+				int i;
+				while ((i = nexti++) < readIndices.size()) {
+					try {
+						fileVideoInfos[readIndices[i]] = readVideoInfo(filenames[readIndices[i]], apiCode);
+					} catch (...) {
+						errors[readIndices[i]] = current_exception();
+					}
+				}
+			}));
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+
+		for (int filei : readIndices) {
+			if (errors[filei]) {
+				rethrow_exception(errors[filei]);
+			}
+			videoInfos[Util::extractFileName(filenames[filei])] = fileVideoInfos[filei];
+			changed = true;
+		}
+	}
+	save(cacheFilename);
+
+	return fileVideoInfos;
+}
+
+VideoInfo VideoInfoCache::readVideoInfo(string filename, int apiCode) {
+	VideoCapture videoCapture;
+	VideoInfo videoInfo;
+	string message;
+
+	videoInfo.header = VideoIndex::getFileHeader(filename);
+	if (videoCapture.open(filename)) {
+		videoInfo.nframes = (int)videoCapture.get(VideoCaptureProperties::CAP_PROP_FRAME_COUNT);
+		videoInfo.width = (int)videoCapture.get(VideoCaptureProperties::CAP_PROP_FRAME_WIDTH);
+		videoInfo.height = (int)videoCapture.get(VideoCaptureProperties::CAP_PROP_FRAME_HEIGHT);
+		videoInfo.fps = videoCapture.get(VideoCaptureProperties::CAP_PROP_FPS);
+		if (videoInfo.fps < 0) {
+			videoInfo.fps = 0;
+		}
+		videoCapture.release();
+	} else {
+		message = "Unable to open capture";
+		if (apiCode != 0) {
+			message += " API code: " + to_string(apiCode);
+		}
+		message += " filename: " + filename;
+		throw ios_base::failure(message);
+	}
+	return videoInfo;
+}
+
+string VideoInfoCache::getCacheFilename(string filename) {
+	return Util::combinePath(Util::extractFilePath(filename), Constants::videoInfoCacheFilename);
+}
@@ -0,0 +1,58 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+
+/*
+ * Video file properties
+ */
+
+class VideoInfo
+{
+public:
+	string header = "";
+	int nframes = 0;
+	int width = 0;
+	int height = 0;
+	double fps = 0;
+};
+
+
+/*
+ * Persistent cache of video file properties, stored per folder and validated by file size and modification time
+ */
+
+class VideoInfoCache
+{
+public:
+	map<string, VideoInfo> videoInfos;
+	bool changed = false;
+
+	VideoInfoCache();
+	void load(string cacheFilename);
+
+	/*
+	 * Replace cache file if changed
+	 */
+	void save(string cacheFilename);
+
+	/*
+	 * Get properties of all files, opening files not (validly) cached in parallel
+	 */
+	vector<VideoInfo> getVideoInfos(vector<string> filenames, int apiCode = 0);
+
+	static VideoInfo readVideoInfo(string filename, int apiCode = 0);
+	static string getCacheFilename(string filename);
+};
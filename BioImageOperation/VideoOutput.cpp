@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #include <filesystem>
+#include <chrono>
 #include "VideoOutput.h"
 #include "Constants.h"
 #include "Util.h"
@@ -31,13 +32,18 @@ void VideoOutput::reset() {
 	fps = 0;
 	codec = 0;
 	close();
+	filename = "";
+	queue = 0;
+	statistics = "";
 }
 
-void VideoOutput::init(string basepath, string filepath, string defaultExtension, string start, string length, double fps, string codecs) {
+void VideoOutput::init(string basepath, string filepath, string defaultExtension, string start, string length, double fps, string codecs,
+					   int queue) {
 	reset();
 
 	outputPath.setOutputPath(basepath, filepath, "", defaultExtension);
 	this->fps = fps;
+	this->queue = queue;
 
 	if (codecs == "") {
 		codecs = Constants::defaultVideoCodec;
@@ -48,7 +54,6 @@ void VideoOutput::init(string basepath, string filepath, string defaultExtension
 
 bool VideoOutput::open() {
 	bool ok = videoIsOpen;
-	string filename;
 
 	if (!videoIsOpen) {
 		filename = outputPath.createFilePath();
@@ -62,6 +67,9 @@ bool VideoOutput::open() {
 				close();
 				throw invalid_argument(Util::format("Unable to create video: %s with encoding: %s @ %dx%d@%ffps", filename.c_str(), Util::getCodecString(codec).c_str(), width, height, fps));
 			}
+			if (queue > 0) {
+				startWriteThread();
+			}
 		} else {
 			ok = false;
 		}
@@ -70,6 +78,11 @@ bool VideoOutput::open() {
 }
 
 bool VideoOutput::writeImage(Mat* image) {
+	FrameItem item;
+	chrono::steady_clock::time_point waitStart;
+	exception_ptr error;
+	bool ok;
+
 	if (Util::isValidImage(image)) {
 		if (!videoIsOpen) {
 			width = image->cols;
@@ -78,8 +91,32 @@ bool VideoOutput::writeImage(Mat* image) {
 			open();
 		}
 
-		if (videoIsOpen) {
+		if (writeThread) {
+			// own copy; script image buffers are reused for next frame
+			item.image = image->clone();
+			if (frameQueue.size() >= queue) {
+				// back-pressure: wait for encoder
+				waitStart = chrono::steady_clock::now();
+				ok = frameQueue.push(item);
+				waitTime += chrono::duration<double>(chrono::steady_clock::now() - waitStart).count();
+				nwaits++;
+			} else {
+				ok = frameQueue.push(item);
+			}
+			if (!ok) {
+				// pass on any error from write thread
+				stopWriteThread();
+				if (writeError) {
+					// passed on once (not reported again on close)
+					error = writeError;
+					writeError = nullptr;
+					rethrow_exception(error);
+				}
+			}
+			return ok;
+		} else if (videoIsOpen) {
 			videoWriter.write(*image);
+			nwritten++;
 			return true;
 		}
 	}
@@ -87,6 +124,57 @@ bool VideoOutput::writeImage(Mat* image) {
 }
 
 void VideoOutput::close() {
+	// finish writing queued frames
+	stopWriteThread();
+	if (videoIsOpen && queue > 0) {
+		statistics = Util::format("%s: %d frames written, waited for encoder %d times (%.1f s)\n",
+								  filename.c_str(), (int)nwritten, nwaits, waitTime);
+	}
+	if (writeError) {
+		// encoder failed after last frame handed over: report, as no later write to pass it on
+		try {
+			rethrow_exception(writeError);
+		} catch (exception& e) {
+			statistics += "Error writing video " + filename + ": " + string(e.what()) + "\n";
+		}
+	}
 	videoWriter.release();
 	videoIsOpen = false;
+	writeError = nullptr;
+	nwritten = 0;
+	nwaits = 0;
+	waitTime = 0;
+}
+
+void VideoOutput::startWriteThread() {
+	frameQueue.reset(queue);
+	writeThread = new std::thread(&VideoOutput::writeThreadMethod, this);
+}
+
+void VideoOutput::stopWriteThread() {
+	if (writeThread) {
+		frameQueue.finish();
+		writeThread->join();
+		delete writeThread;
+		writeThread = nullptr;
+	}
+}
+
+void VideoOutput::writeThreadMethod() {
+	FrameItem item;
+
+	try {
+		while (frameQueue.pop(item)) {
+			videoWriter.write(item.image);
+			nwritten++;
+		}
+	} catch (...) {
+		// passed on at next write
+		writeError = current_exception();
+		frameQueue.abort();
+	}
+}
+
+string VideoOutput::getStatistics() {
+	return statistics;
 }
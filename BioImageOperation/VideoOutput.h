@@ -8,8 +8,12 @@
  *****************************************************************************/
 
 #pragma once
+#include <thread>
+#include <atomic>
+#include <exception>
 #include <opencv2/opencv.hpp>
 #include "FrameOutput.h"
+#include "FrameQueue.h"
 #include "NumericPath.h"
 
 using namespace cv;
@@ -30,12 +34,32 @@ public:
 	bool isColor = true;
 	double fps = 0;
 	int codec = 0;
+	string filename = "";
+
+	int queue = 0;
+	std::thread* writeThread = nullptr;
+	FrameQueue frameQueue;
+	exception_ptr writeError = nullptr;
+	atomic<int> nwritten = 0;
+	int nwaits = 0;
+	double waitTime = 0;
+	string statistics = "";
 
 	VideoOutput();
 	~VideoOutput();
-	void init(string basepath, string filepath, string defaultExtension = "", string start = "", string length = "", double fps = 0, string codecs = "");
+	void init(string basepath, string filepath, string defaultExtension = "", string start = "", string length = "", double fps = 0, string codecs = "",
+			  int queue = 0);
 	void reset();
 	bool open();
 	void close();
 	bool writeImage(Mat* image);
+
+	/*
+	 * Queue mode: encode frames in separate thread; script waits only when queue is full
+	 */
+	void startWriteThread();
+	void stopWriteThread();
+	void writeThreadMethod();
+
+	string getStatistics();
 };
@@ -8,6 +8,8 @@
  *****************************************************************************/
 
 #include "VideoSource.h"
+#include "VideoInfoCache.h"
+#include "ImageOperations.h"
 #include "Constants.h"
 #include "Util.h"
 
@@ -29,6 +31,7 @@ void VideoSource::reset() {
 	videoNframes = 0;
 	framei = 0;
 	videoFramei = 0;
+	videoPosition = 0;
 	width = 0;
 	height = 0;
 	fps = 1;
@@ -36,16 +39,24 @@ void VideoSource::reset() {
 	end = 0;
 	interval = 1;
 	seekMode = false;
+	videoIndex.reset();
+	prefetch = 0;
+	outputFramei = 0;
+	outputLabel = "";
+	colorMode = -1;
+	cachei = 0;
 	close();
+	frameCache.reset();
 }
 
 bool VideoSource::init(string basepath, string filepath, int apiCode, string codecs, string start, string length,
-					   double fps0, int interval, int total, int width, int height) {
-	string filename;
+					   double fps0, int interval, int total, int width, int height, int prefetch, int dropMode,
+					   bool cache, int colorMode, double timeout) {
+	VideoInfoCache videoInfoCache;
+	vector<string> filenames;
+	string filename, cacheKey, cacheFilename;
 	bool ok = false;
 	bool canSeek;
-	int nframes0;
-    string message;
 
     reset();
     this->apiCode = apiCode;
@@ -56,34 +67,24 @@ bool VideoSource::init(string basepath, string filepath, int apiCode, string cod
         throw ios_base::failure("File(s) not found: " + sourcePath.templatePath);
     }
 
-	nframes = 0;
 	do {
 		filename = sourcePath.createFilePath();
 		if (filename != "") {
-			if (videoCapture.open(filename)) {
-				nframes0 = (int)videoCapture.get(VideoCaptureProperties::CAP_PROP_FRAME_COUNT);
-				if (nframes0 > 0) {
-					nframes += nframes0;
-				}
-				width = (int)videoCapture.get(VideoCaptureProperties::CAP_PROP_FRAME_WIDTH);
-				height = (int)videoCapture.get(VideoCaptureProperties::CAP_PROP_FRAME_HEIGHT);
-				fps = videoCapture.get(VideoCaptureProperties::CAP_PROP_FPS);
-				if (fps < 0) {
-					fps = 0;
-				}
-			} else {
-				message = "Unable to open capture";
-				if (apiCode != 0) {
-					message += " API code: " + to_string(apiCode);
-				}
-				message += " filename: " + filename;
-				throw ios_base::failure(message);
-
-			}
-			videoCapture.release();
+			filenames.push_back(filename);
 		}
 	} while (filename != "");
 
+	// file properties from cache, only opening new or modified files
+	nframes = 0;
+	for (VideoInfo videoInfo : videoInfoCache.getVideoInfos(filenames, apiCode)) {
+		if (videoInfo.nframes > 0) {
+			nframes += videoInfo.nframes;
+		}
+		width = videoInfo.width;
+		height = videoInfo.height;
+		fps = videoInfo.fps;
+	}
+
 	sourcePath.resetFilePath();
 
 	calcFrameParams(start, length, fps, interval, total, nframes);
@@ -91,6 +92,18 @@ bool VideoSource::init(string basepath, string filepath, int apiCode, string cod
 	canSeek = (nframes != 0);
 	seekMode = (canSeek && this->interval >= Constants::seekModeInterval);		// auto select seek mode: if interval >= x frames
 
+	this->colorMode = colorMode;
+	if (cache) {
+		cacheKey = getCacheKey(filenames);
+		cacheFilename = FrameCache::getCacheFilename(filenames[0], cacheKey);
+		if (frameCache.openRead(cacheFilename, cacheKey)) {
+			// decoded frames from previous run; video not needed
+			outputFramei = frameCache.initialFramei;
+			outputLabel = Util::extractFileTitle(filenames[0]);
+			return true;
+		}
+	}
+
 	ok = open();
 	if (ok) {
 		framei = this->start;
@@ -102,6 +115,17 @@ bool VideoSource::init(string basepath, string filepath, int apiCode, string cod
 				nextFrame();
 			}
 		}
+		outputFramei = framei;
+		outputLabel = label;
+
+		if (cache) {
+			frameCache.openWrite(cacheFilename, cacheKey, outputFramei);
+		}
+
+		this->prefetch = prefetch;
+		if (prefetch > 0) {
+			startDecodeThread();
+		}
 	}
 
 	return ok;
@@ -125,6 +149,13 @@ bool VideoSource::open() {
 				sourcei++;
 				videoIsOpen = videoCapture.isOpened();
                 ok = videoIsOpen;
+				videoPosition = 0;
+				if (seekMode && videoCapture.getBackendName() == "FFMPEG") {
+					// index created with FFmpeg: frame numbers only valid for same backend
+					videoIndex.init(filename);
+				} else {
+					videoIndex.reset();
+				}
 			}
 
 			if (!videoIsOpen) {
@@ -149,10 +180,59 @@ void VideoSource::release() {
 }
 
 void VideoSource::close() {
+	stopDecodeThread();
 	release();
+	frameCache.close();
 }
 
 bool VideoSource::getNextImage(Mat* image) {
+	FrameItem item;
+	bool frameOk = false;
+
+	if (frameCache.isReading()) {
+		return frameCache.getFrame(cachei++, image, &outputFramei, &outputLabel);
+	}
+
+	if (decodeThread) {
+		frameOk = frameQueue.pop(item);
+		if (frameOk) {
+			*image = item.image;
+			outputFramei = item.framei;
+			outputLabel = item.label;
+		} else {
+			// pass on any error from decode thread
+			frameQueue.checkError();
+		}
+	} else {
+		frameOk = readNextImage(image);
+		outputFramei = framei;
+		outputLabel = label;
+	}
+
+	if (frameOk) {
+		switch ((ImageColorMode)colorMode) {
+		case ImageColorMode::GrayScale: ImageOperations::convertToGrayScale(*image, *image); break;
+		case ImageColorMode::Color: ImageOperations::convertToColor(*image, *image); break;
+		case ImageColorMode::ColorAlpha: ImageOperations::convertToColorAlpha(*image, *image); break;
+		}
+		frameCache.writeFrame(*image, outputFramei, outputLabel);
+	} else {
+		// complete source decoded
+		frameCache.finishWrite();
+	}
+	return frameOk;
+}
+
+string VideoSource::getCacheKey(vector<string> filenames) {
+	string key = Util::format("%d,%d,%d,%d", start, end, interval, colorMode);
+
+	for (string filename : filenames) {
+		key += ";" + Util::extractFileName(filename) + "," + VideoIndex::getFileHeader(filename);
+	}
+	return key;
+}
+
+bool VideoSource::readNextImage(Mat* image) {
 	bool frameOk = false;
 
 	if (seekMode) {
@@ -189,6 +269,40 @@ bool VideoSource::getNextImage(Mat* image) {
 	return (frameOk && videoIsOpen);
 }
 
+void VideoSource::startDecodeThread() {
+	frameQueue.reset(prefetch);
+	decodeThread = new std::thread(&VideoSource::decodeThreadMethod, this);
+}
+
+void VideoSource::stopDecodeThread() {
+	if (decodeThread) {
+		frameQueue.abort();
+		decodeThread->join();
+		delete decodeThread;
+		decodeThread = nullptr;
+	}
+}
+
+void VideoSource::decodeThreadMethod() {
+	FrameItem item;
+	bool frameOk = true;
+
+	try {
+		while (frameOk) {
+			item.image = Mat();		// new buffer; previous frame owned by queue
+			frameOk = readNextImage(&item.image);
+			if (frameOk) {
+				item.framei = framei;
+				item.label = label;
+				frameOk = frameQueue.push(item);
+			}
+		}
+		frameQueue.finish();
+	} catch (...) {
+		frameQueue.finish(current_exception());
+	}
+}
+
 bool VideoSource::seekFrame() {
 	bool openOk = true;
 
@@ -198,6 +312,31 @@ bool VideoSource::seekFrame() {
 		videoIsOpen = false;
 		openOk = open();
 	}
+
+	if (videoIndex.isSet()) {
+		// only seek if target not reachable by grabbing forward within current key frame interval
+		int keyFrame = videoIndex.getKeyFrame(videoFramei);
+		if (videoPosition < keyFrame || videoPosition > videoFramei) {
+			if (videoCapture.set(VideoCaptureProperties::CAP_PROP_POS_FRAMES, keyFrame)
+				&& (int)videoCapture.get(VideoCaptureProperties::CAP_PROP_POS_FRAMES) == keyFrame) {
+				videoPosition = keyFrame;
+			} else {
+				// index (packet order) does not match decoded frame numbers: no longer use index, seek as without
+				videoIndex.reset();
+				videoPosition = videoFramei;
+				return videoCapture.set(VideoCaptureProperties::CAP_PROP_POS_FRAMES, videoFramei);
+			}
+		}
+		while (videoPosition < videoFramei) {
+			if (!videoCapture.grab()) {
+				return false;
+			}
+			videoPosition++;
+		}
+		return true;
+	}
+
+	videoPosition = videoFramei;
 	return videoCapture.set(VideoCaptureProperties::CAP_PROP_POS_FRAMES, videoFramei);
 }
 
@@ -215,6 +354,7 @@ bool VideoSource::nextFrame() {
 		}
 		if (videoIsOpen) {
 			frameOk = videoCapture.grab();
+			videoPosition++;
 			if (!frameOk) {
 				if (framei > 0 && framei < 100 && framei < videoNframes - 1) {
 					// work-around for initial empty frames in stream
@@ -243,15 +383,15 @@ double VideoSource::getFps() {
 }
 
 int VideoSource::getFrameNumber() {
-	return framei;
+	return outputFramei;
 }
 
 string VideoSource::getLabel() {
-	return label;
+	return outputLabel;
 }
 
 int VideoSource::getCurrentFrame() {
-	return framei - start;
+	return outputFramei - start;
 }
 
 int VideoSource::getTotalFrames() {
@@ -9,8 +9,12 @@
 
 #pragma once
 #include <string>
+#include <thread>
 #include <opencv2/opencv.hpp>
 #include "FrameSource.h"
+#include "FrameQueue.h"
+#include "VideoIndex.h"
+#include "FrameCache.h"
 #include "NumericPath.h"
 
 using namespace std;
@@ -35,19 +39,42 @@ public:
 	int videoNframes = 0;
 	int framei = 0;
 	int videoFramei = 0;
+	int videoPosition = 0;
 	int width = 0;
 	int height = 0;
 	bool seekMode = false;
+	VideoIndex videoIndex;
+
+	int prefetch = 0;
+	std::thread* decodeThread = nullptr;
+	FrameQueue frameQueue;
+	int outputFramei = 0;
+	string outputLabel = "";
+
+	int colorMode = -1;
+	FrameCache frameCache;
+	int cachei = 0;
 
 	VideoSource();
 	~VideoSource();
 	void reset();
 	bool init(string basepath, string filepath, int apiCode, string codecs = "", string start = "", string length = "",
-			  double fps = 1, int interval = 1, int total = 0, int width=0, int height=0);
+			  double fps = 1, int interval = 1, int total = 0, int width=0, int height=0, int prefetch = 0, int dropMode = 0,
+			  bool cache = false, int colorMode = -1, double timeout = 0);
 	bool open();
 	void release();
 	void close();
 	bool getNextImage(Mat* image);
+	bool readNextImage(Mat* image);
+	string getCacheKey(vector<string> filenames);
+
+	/*
+	 * Prefetch mode: decode frames in separate thread ahead of processing
+	 */
+	void startDecodeThread();
+	void stopDecodeThread();
+	void decodeThreadMethod();
+
 	bool seekFrame();
 	bool nextFrame();
 
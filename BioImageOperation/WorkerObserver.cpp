@@ -0,0 +1,67 @@
+/*****************************************************************************
+ * Bio Image Operation (BIO)
+ * Copyright (C) 2013-2020 Joost de Folter <folterj@gmail.com>
+ * and the BIO developers.
+ * This software is licensed under the terms of the GPL3 License.
+ * See LICENSE.md in the project root folder for more information.
+ * https://github.com/folterj/BioImageOperation
+ *****************************************************************************/
+
+#include "WorkerObserver.h"
+
+
+void WorkerObserver::requestPause() {
+}
+
+void WorkerObserver::resetProgressTimer() {
+}
+
+bool WorkerObserver::checkStatusProcess() {
+	return true;
+}
+
+bool WorkerObserver::checkOperationsProcess() {
+	return false;
+}
+
+bool WorkerObserver::checkTextProcess(int displayi) {
+	return false;
+}
+
+bool WorkerObserver::checkImageProcess(int displayi) {
+	return false;
+}
+
+void WorkerObserver::setMode(int mode) {
+}
+
+void WorkerObserver::clearStatus() {
+}
+
+void WorkerObserver::showStatus(int i, int tot, string label) {
+	progress = i;
+	if (tot > 0) {
+		total = tot;
+	}
+}
+
+void WorkerObserver::showOperations(ScriptOperations* operations, ScriptOperation* currentOperation) {
+}
+
+void WorkerObserver::showDialog(string message, int level) {
+	lock_guard<mutex> lock(errorMutex);
+	if (level == (int)MessageLevel::Error && error == "") {
+		error = message;
+	}
+}
+
+void WorkerObserver::showText(string text, int displayi, string reference) {
+}
+
+void WorkerObserver::showImage(Mat* image, int displayi, string reference) {
+}
+
+string WorkerObserver::getError() {
+	lock_guard<mutex> lock(errorMutex);
+	return error;
+}